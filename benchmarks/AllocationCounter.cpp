@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> allocationCount = 0;
+
+	void* AllocateCore(std::size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+		void* ptr = std::malloc(size != 0 ? size : 1);
+
+		if (!ptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return ptr;
+	}
+}
+
+uint64_t AllocationCounter::GetAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+	return AllocateCore(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return AllocateCore(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	return std::malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
@@ -0,0 +1,25 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+// Counts the heap allocations made through the global operator new.
+// The counter is shared by all threads, the benchmarks are single-threaded.
+namespace AllocationCounter
+{
+	/**
+	 * @brief Gets the number of allocations made since the process started.
+	 * @return The number of allocations made since the process started.
+	*/
+	uint64_t GetAllocationCount();
+}
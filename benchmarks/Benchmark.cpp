@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	std::string EscapeJsonString(const std::string& value)
+	{
+		std::string escaped;
+		escaped.reserve(value.size());
+
+		for (char c : value)
+		{
+			if (c == '"' || c == '\\')
+			{
+				escaped.push_back('\\');
+			}
+
+			escaped.push_back(c);
+		}
+
+		return escaped;
+	}
+}
+
+BenchmarkRunner::BenchmarkRunner(std::chrono::nanoseconds minimumTime, const std::string& filter)
+	: minimumTime(minimumTime),
+	  filter(filter),
+	  results()
+{
+}
+
+void BenchmarkRunner::Run(const std::string& name, const std::function<void()>& operation)
+{
+	if (!filter.empty() && name.find(filter) == std::string::npos)
+	{
+		return;
+	}
+
+	// Warm up the caches and any lazily initialized state.
+	operation();
+
+	uint64_t iterations = 1;
+	std::chrono::nanoseconds elapsed{};
+	uint64_t allocations = 0;
+
+	while (true)
+	{
+		const uint64_t allocationsBefore = AllocationCounter::GetAllocationCount();
+		const auto start = std::chrono::steady_clock::now();
+
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			operation();
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+		allocations = AllocationCounter::GetAllocationCount() - allocationsBefore;
+
+		if (elapsed >= minimumTime)
+		{
+			break;
+		}
+
+		iterations *= 2;
+	}
+
+	BenchmarkResult result
+	{
+		name,
+		iterations,
+		static_cast<double>(elapsed.count()) / static_cast<double>(iterations),
+		static_cast<double>(allocations) / static_cast<double>(iterations)
+	};
+
+	std::printf(
+		"%-56s %12.1f ns/op %8.2f allocs/op\n",
+		result.name.c_str(),
+		result.nanosecondsPerOperation,
+		result.allocationsPerOperation);
+	std::fflush(stdout);
+
+	results.push_back(std::move(result));
+}
+
+bool BenchmarkRunner::WriteJson(const std::filesystem::path& path) const
+{
+	std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "{\n  \"benchmarks\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+
+		char buffer[512]{};
+
+		std::snprintf(
+			buffer,
+			sizeof(buffer),
+			"    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f}%s\n",
+			EscapeJsonString(result.name).c_str(),
+			static_cast<unsigned long long>(result.iterations),
+			result.nanosecondsPerOperation,
+			result.allocationsPerOperation,
+			i + 1 < results.size() ? "," : "");
+
+		stream << buffer;
+	}
+
+	stream << "  ]\n}\n";
+
+	return static_cast<bool>(stream);
+}
+
+const std::vector<BenchmarkResult>& BenchmarkRunner::Results() const
+{
+	return results;
+}
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult
+{
+	std::string name;
+	uint64_t iterations;
+	double nanosecondsPerOperation;
+	double allocationsPerOperation;
+};
+
+// Runs each benchmark for at least the minimum time and records the
+// average time and heap allocation count of a single operation.
+class BenchmarkRunner
+{
+public:
+
+	/**
+	 * @brief Constructs an instance of the class.
+	 * @param minimumTime The minimum time that each benchmark runs for.
+	 * @param filter Only benchmarks whose name contains this string are run,
+	 * an empty string runs all of the benchmarks.
+	*/
+	BenchmarkRunner(std::chrono::nanoseconds minimumTime, const std::string& filter);
+
+	/**
+	 * @brief Runs a benchmark.
+	 * @param name The benchmark name.
+	 * @param operation The operation to measure, it is called once per iteration.
+	*/
+	void Run(const std::string& name, const std::function<void()>& operation);
+
+	/**
+	 * @brief Writes the results as a JSON document.
+	 * @param path The output file path.
+	 * @return True on success; otherwise, false.
+	*/
+	bool WriteJson(const std::filesystem::path& path) const;
+
+	const std::vector<BenchmarkResult>& Results() const;
+
+private:
+
+	std::chrono::nanoseconds minimumTime;
+	std::string filter;
+	std::vector<BenchmarkResult> results;
+};
+
+/**
+ * @brief Prevents the compiler from optimizing away a value that the benchmark
+ * does not otherwise use.
+ * @param value The value to keep.
+*/
+template <typename T> inline void DoNotOptimize(const T& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
@@ -0,0 +1,518 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Microbenchmarks for the ordinance entry points that the game calls every
+// month and every time the budget window is redrawn.
+
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include "cIGZSerializable.h"
+#include "CityLotteryOrdinance.h"
+#include "CityScenario.h"
+#include "IncomeKernel.h"
+#include "Logger.h"
+#include "MemoryDBSegmentIStream.h"
+#include "MemoryDBSegmentOStream.h"
+#include "OrdinancePropertyHolder.h"
+#include "SaveRecordCodec.h"
+#include "Settings.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		std::chrono::milliseconds minimumTime{ 200 };
+		std::string filter;
+		std::filesystem::path jsonPath = "benchmark_results.json";
+		std::filesystem::path settingsPath = SC4_DEFAULT_SETTINGS_PATH;
+		std::filesystem::path logPath = std::filesystem::temp_directory_path() / "SC4CityLotteryOrdinanceBenchmark.log";
+		LogWriteMode logWriteMode = LogWriteMode::Asynchronous;
+		size_t logMaxFileSize = 0;
+	};
+
+	constexpr uint32_t PropertyCounts[] = { 3, 16, 64 };
+
+	void PrintUsage(const char* programName)
+	{
+		std::printf(
+			"Usage: %s [options]\n"
+			"  --min-time <ms>     The minimum run time of each benchmark, defaults to 200.\n"
+			"  --filter <text>     Only run the benchmarks whose name contains <text>.\n"
+			"  --json <path>       The JSON results file, defaults to benchmark_results.json.\n"
+			"  --settings <path>   The SC4CityLotteryOrdinance.ini file used by the Settings::Load benchmark.\n"
+			"  --log <path>        The log file used by the Logger benchmarks.\n"
+			"  --log-mode <mode>   The log write mode: async (the default), sync or trace.\n"
+			"  --log-max-size <bytes>\n"
+			"                      Write the text log through a rotating memory-mapped file of this size.\n",
+			programName);
+	}
+
+	bool ParseOptions(int argc, char** argv, BenchmarkOptions& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* arg = argv[i];
+			const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+			if (std::strcmp(arg, "--help") == 0)
+			{
+				return false;
+			}
+
+			if (!value)
+			{
+				std::fprintf(stderr, "Missing value for %s.\n", arg);
+				return false;
+			}
+
+			if (std::strcmp(arg, "--min-time") == 0)
+			{
+				options.minimumTime = std::chrono::milliseconds(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--filter") == 0)
+			{
+				options.filter = value;
+			}
+			else if (std::strcmp(arg, "--json") == 0)
+			{
+				options.jsonPath = value;
+			}
+			else if (std::strcmp(arg, "--settings") == 0)
+			{
+				options.settingsPath = value;
+			}
+			else if (std::strcmp(arg, "--log") == 0)
+			{
+				options.logPath = value;
+			}
+			else if (std::strcmp(arg, "--log-max-size") == 0)
+			{
+				options.logMaxFileSize = static_cast<size_t>(std::strtoull(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--log-mode") == 0)
+			{
+				if (std::strcmp(value, "async") == 0)
+				{
+					options.logWriteMode = LogWriteMode::Asynchronous;
+				}
+				else if (std::strcmp(value, "sync") == 0)
+				{
+					options.logWriteMode = LogWriteMode::Synchronous;
+				}
+				else if (std::strcmp(value, "trace") == 0)
+				{
+					options.logWriteMode = LogWriteMode::BinaryTrace;
+				}
+				else
+				{
+					std::fprintf(stderr, "Unknown log mode: %s\n", value);
+					return false;
+				}
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option: %s\n", arg);
+				return false;
+			}
+
+			i++;
+		}
+
+		return true;
+	}
+
+	OrdinancePropertyHolder CreatePropertyHolder(uint32_t propertyCount)
+	{
+		OrdinancePropertyHolder holder;
+
+		for (uint32_t i = 0; i < propertyCount; i++)
+		{
+			holder.AddProperty(0x10000000 + i, static_cast<float>(i));
+		}
+
+		return holder;
+	}
+
+	// The linear scan that OrdinancePropertyHolder used before it kept the properties
+	// sorted, this is the baseline for the lookup benchmarks.
+	bool LinearScanHasProperty(const std::vector<cSCBaseProperty>& properties, uint32_t propertyID)
+	{
+		for (const auto& property : properties)
+		{
+			if (property.GetPropertyID() == propertyID)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void RunOrdinanceBenchmarks(BenchmarkRunner& runner, const Settings& settings)
+	{
+		CityLotteryOrdinance ordinance;
+		CityScenario scenario(ordinance, settings);
+
+		if (!scenario.LoadCity())
+		{
+			std::fprintf(stderr, "Failed to initialize the ordinance.\n");
+			return;
+		}
+
+		runner.Run("CityLotteryOrdinance::GetCurrentMonthlyIncome", [&]()
+		{
+			DoNotOptimize(ordinance.GetCurrentMonthlyIncome());
+		});
+
+		runner.Run("OrdinanceBase::Simulate", [&]()
+		{
+			DoNotOptimize(ordinance.Simulate());
+		});
+
+		runner.Run("CityScenario::SimulateMonth/4 budget polls", [&]()
+		{
+			DoNotOptimize(scenario.SimulateMonth(4));
+		});
+
+		MemoryDBSegmentOStream output;
+		MemoryDBSegmentIStream input;
+		CityLotteryOrdinance loadedOrdinance;
+
+		runner.Run("CityLotteryOrdinance::Write", [&]()
+		{
+			output.Clear();
+			DoNotOptimize(ordinance.Write(output));
+		});
+
+		runner.Run("CityLotteryOrdinance::Write+Read", [&]()
+		{
+			output.Clear();
+			ordinance.Write(output);
+			input.Reset(output.Data());
+			DoNotOptimize(loadedOrdinance.Read(input));
+		});
+
+		runner.Run("CityLotteryOrdinance::UpdateOrdinanceData", [&]()
+		{
+			loadedOrdinance.UpdateOrdinanceData(settings);
+			DoNotOptimize(loadedOrdinance.GetMiscProperties());
+		});
+
+		scenario.ShutdownCity();
+	}
+
+	void RunIncomeKernelBenchmarks(BenchmarkRunner& runner)
+	{
+		constexpr size_t GroupCount = 12;
+
+		float populations[GroupCount]{};
+		float factors[GroupCount]{};
+		IncomeKernel::FixedPointFactor fixedPointFactors[GroupCount]{};
+
+		for (size_t i = 0; i < GroupCount; i++)
+		{
+			populations[i] = static_cast<float>(1000 * (i + 1));
+			factors[i] = 0.01f * static_cast<float>(i + 1);
+			fixedPointFactors[i] = IncomeKernel::ToFixedPoint(factors[i]);
+		}
+
+		for (size_t groupCount : { size_t(3), GroupCount })
+		{
+			const std::string suffix = "/" + std::to_string(groupCount) + " census groups";
+
+			runner.Run("IncomeKernel::CalculateFixedPoint" + suffix, [&]()
+			{
+				DoNotOptimize(IncomeKernel::CalculateFixedPoint(500, populations, fixedPointFactors, groupCount));
+			});
+
+			runner.Run("IncomeKernel::CalculateDouble" + suffix, [&]()
+			{
+				DoNotOptimize(IncomeKernel::CalculateDouble(500, populations, factors, groupCount));
+			});
+		}
+	}
+
+	void RunPropertyHolderBenchmarks(BenchmarkRunner& runner)
+	{
+		for (uint32_t propertyCount : PropertyCounts)
+		{
+			OrdinancePropertyHolder holder = CreatePropertyHolder(propertyCount);
+			const uint32_t lastPropertyID = 0x10000000 + propertyCount - 1;
+			const uint32_t missingPropertyID = 0x20000000;
+			const std::string suffix = "/" + std::to_string(propertyCount) + " properties";
+
+			std::vector<cSCBaseProperty> unsortedProperties;
+
+			for (uint32_t i = 0; i < propertyCount; i++)
+			{
+				unsortedProperties.emplace_back(0x10000000 + i, static_cast<float>(i));
+			}
+
+			runner.Run("LinearScan::HasProperty/hit" + suffix, [&]()
+			{
+				DoNotOptimize(LinearScanHasProperty(unsortedProperties, lastPropertyID));
+			});
+
+			runner.Run("LinearScan::HasProperty/miss" + suffix, [&]()
+			{
+				DoNotOptimize(LinearScanHasProperty(unsortedProperties, missingPropertyID));
+			});
+
+			runner.Run("OrdinancePropertyHolder::HasProperty/hit" + suffix, [&]()
+			{
+				DoNotOptimize(holder.HasProperty(lastPropertyID));
+			});
+
+			runner.Run("OrdinancePropertyHolder::HasProperty/miss" + suffix, [&]()
+			{
+				DoNotOptimize(holder.HasProperty(missingPropertyID));
+			});
+
+			runner.Run("OrdinancePropertyHolder::GetProperty/hit" + suffix, [&]()
+			{
+				DoNotOptimize(holder.GetProperty(lastPropertyID));
+			});
+
+			runner.Run("OrdinancePropertyHolder::GetProperty/miss" + suffix, [&]()
+			{
+				DoNotOptimize(holder.GetProperty(missingPropertyID));
+			});
+
+			// The holders that GetProperty or EnumProperties has handed out writable properties
+			// for are copied, the others share the set. The settings' holder is never exposed,
+			// but the game's first GetProperty call copies the ordinance's set once.
+			const OrdinancePropertyHolder sharedHolder = CreatePropertyHolder(propertyCount);
+			OrdinancePropertyHolder exposedHolder = CreatePropertyHolder(propertyCount);
+			exposedHolder.EnumProperties([](cISCProperty*, void*) {}, nullptr);
+
+			runner.Run("OrdinancePropertyHolder::Copy/shared" + suffix, [&]()
+			{
+				OrdinancePropertyHolder copy(sharedHolder);
+				DoNotOptimize(copy.HasProperty(lastPropertyID));
+			});
+
+			runner.Run("OrdinancePropertyHolder::Copy/exposed" + suffix, [&]()
+			{
+				OrdinancePropertyHolder copy(exposedHolder);
+				DoNotOptimize(copy.HasProperty(lastPropertyID));
+			});
+
+			runner.Run("OrdinancePropertyHolder::Copy+GetProperty" + suffix, [&]()
+			{
+				OrdinancePropertyHolder copy(sharedHolder);
+				cISCProperty* property = copy.GetProperty(lastPropertyID);
+				DoNotOptimize(property);
+				property->Release();
+			});
+
+			MemoryDBSegmentOStream output;
+			MemoryDBSegmentIStream input;
+			OrdinancePropertyHolder loadedHolder;
+
+			runner.Run("OrdinancePropertyHolder::Write+Read" + suffix, [&]()
+			{
+				output.Clear();
+				holder.Write(output);
+				input.Reset(output.Data());
+				DoNotOptimize(loadedHolder.Read(input));
+			});
+
+			runner.Run("OrdinancePropertyHolder::Write+Read/record" + suffix, [&]()
+			{
+				SaveRecordWriter writer(1);
+				holder.Write(writer);
+
+				SaveRecordReader reader(
+					writer.Data() + SaveRecordWriter::HeaderSize,
+					writer.Size() - SaveRecordWriter::HeaderSize);
+				DoNotOptimize(loadedHolder.Read(reader));
+			});
+		}
+	}
+
+	// The size of a save and the number of stream calls, the game's DB segment streams
+	// have a per-call overhead that the memory streams do not.
+	void PrintSaveSize(const char* name, const MemoryDBSegmentOStream& output)
+	{
+		// The stream is empty if the benchmark was excluded by the filter.
+		if (output.GetCallCount() == 0)
+		{
+			return;
+		}
+
+		std::printf(
+			"%s save: %llu bytes, %llu stream writes\n",
+			name,
+			static_cast<unsigned long long>(output.GetByteCount()),
+			static_cast<unsigned long long>(output.GetCallCount()));
+	}
+
+	void RunSerializationBenchmarks(BenchmarkRunner& runner)
+	{
+		MemoryDBSegmentOStream output;
+		MemoryDBSegmentIStream input;
+
+		const cSCBaseProperty property(0x10000000, 1.5f);
+		cSCBaseProperty loadedProperty;
+
+		runner.Run("cSCBaseProperty::Write+Read", [&]()
+		{
+			output.Clear();
+			property.Write(output);
+			input.Reset(output.Data());
+			DoNotOptimize(loadedProperty.Read(input));
+		});
+
+		PrintSaveSize("cSCBaseProperty", output);
+
+		// The ordinance serialization is only reachable through QueryInterface, like in the game.
+		OrdinanceBase ordinance(0x10000000, "Benchmark", "Benchmark", 1000, -500, 100, 0.5f, true, CreatePropertyHolder(16));
+		OrdinanceBase loadedOrdinance(0, "", "", 0, 0, 0, 0.0f, false);
+
+		cIGZSerializable* serializable = nullptr;
+		cIGZSerializable* loadedSerializable = nullptr;
+
+		if (!ordinance.QueryInterface(GZIID_cIGZSerializable, reinterpret_cast<void**>(&serializable))
+			|| !loadedOrdinance.QueryInterface(GZIID_cIGZSerializable, reinterpret_cast<void**>(&loadedSerializable)))
+		{
+			std::fprintf(stderr, "The ordinance does not support cIGZSerializable.\n");
+			return;
+		}
+
+		runner.Run("OrdinanceBase::Write+Read/16 properties", [&]()
+		{
+			output.Clear();
+			serializable->Write(output);
+			input.Reset(output.Data());
+			DoNotOptimize(loadedSerializable->Read(input));
+		});
+
+		PrintSaveSize("OrdinanceBase", output);
+
+		serializable->Release();
+		loadedSerializable->Release();
+	}
+
+	void RunSettingsBenchmarks(BenchmarkRunner& runner, const std::filesystem::path& settingsPath)
+	{
+		runner.Run("Settings::Load", [&]()
+		{
+			Settings settings;
+			settings.Load(settingsPath);
+			DoNotOptimize(settings.MonthlyConstantIncome());
+		});
+	}
+
+	void RunLoggerBenchmarks(BenchmarkRunner& runner, LogWriteMode logWriteMode, size_t logMaxFileSize)
+	{
+		Logger& logger = Logger::GetInstance();
+
+		std::string modeSuffix;
+
+		switch (logWriteMode)
+		{
+		case LogWriteMode::Asynchronous:
+			modeSuffix = "/async";
+			break;
+		case LogWriteMode::BinaryTrace:
+			modeSuffix = "/trace";
+			break;
+		default:
+			modeSuffix = "/sync";
+			break;
+		}
+
+		if (logMaxFileSize > 0)
+		{
+			modeSuffix += "/mapped";
+		}
+
+		runner.Run("Logger::WriteLineFormatted/enabled" + modeSuffix, [&]()
+		{
+			logger.WriteLineFormatted(LogOptions::Errors, "%s: value=%d", __FUNCTION__, 42);
+		});
+
+		runner.Run("Logger::WriteLineFormatted/disabled" + modeSuffix, [&]()
+		{
+			logger.WriteLineFormatted(LogOptions::OrdinanceAPI, "%s: value=%d", __FUNCTION__, 42);
+		});
+
+		// A line that repeats the previous one, which is counted instead of being written.
+		logger.SetDeduplicationEnabled(true);
+
+		runner.Run("Logger::WriteLineFormatted/repeated" + modeSuffix, [&]()
+		{
+			logger.WriteLineFormatted(LogOptions::Errors, "%s: value=%d", __FUNCTION__, 42);
+		});
+
+		logger.SetDeduplicationEnabled(false);
+
+		// The benchmark writes lines much faster than the game does, the lines that
+		// did not fit in the ring buffer are counted instead of blocking the caller.
+		logger.Flush();
+
+		if (logWriteMode == LogWriteMode::Asynchronous)
+		{
+			std::printf("dropped log lines: %llu\n", static_cast<unsigned long long>(logger.GetDroppedLineCount()));
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Only the Errors category is enabled, so that the ordinance API logging
+	// does not dominate the ordinance benchmarks.
+	Logger::GetInstance().Init(options.logPath, LogOptions::Errors, options.logWriteMode, options.logMaxFileSize);
+
+	Settings settings;
+
+	try
+	{
+		settings.Load(options.settingsPath);
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "Failed to load the settings: %s\n", e.what());
+		return EXIT_FAILURE;
+	}
+
+	BenchmarkRunner runner(options.minimumTime, options.filter);
+
+	RunOrdinanceBenchmarks(runner, settings);
+	RunIncomeKernelBenchmarks(runner);
+	RunPropertyHolderBenchmarks(runner);
+	RunSerializationBenchmarks(runner);
+	RunSettingsBenchmarks(runner, options.settingsPath);
+	RunLoggerBenchmarks(runner, options.logWriteMode, options.logMaxFileSize);
+
+	Logger::GetInstance().Shutdown();
+
+	if (!runner.WriteJson(options.jsonPath))
+	{
+		std::fprintf(stderr, "Failed to write %s.\n", options.jsonPath.string().c_str());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
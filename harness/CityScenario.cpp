@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "CityScenario.h"
+#include "CityLotteryOrdinance.h"
+#include "ISettings.h"
+#include "Logger.h"
+#include "RegisteredOrdinanceDump.h"
+#include "TraceEventRecorder.h"
+
+namespace
+{
+	// The population cycles every 500 years so that long runs stay within a realistic range.
+	constexpr uint64_t kPopulationCycleMonths = 6000;
+
+	constexpr uint32_t kResidentialLowWealthGroupID = 0x1011;
+	constexpr uint32_t kResidentialMedWealthGroupID = 0x1021;
+	constexpr uint32_t kResidentialHighWealthGroupID = 0x1031;
+}
+
+CityScenario::CityScenario(CityLotteryOrdinance& ordinance, const ISettings& settings)
+	: ordinance(ordinance),
+	  settings(settings),
+	  city(),
+	  monthCount(0),
+	  cityLoaded(false)
+{
+}
+
+bool CityScenario::LoadCity()
+{
+	if (cityLoaded)
+	{
+		return true;
+	}
+
+	UpdatePopulation();
+
+	if (!ordinance.PostCityInit(&city))
+	{
+		return false;
+	}
+
+	if (!city.OrdinanceSimulator().AddOrdinance(ordinance))
+	{
+		ordinance.PreCityShutdown(&city);
+		return false;
+	}
+
+	ordinance.UpdateOrdinanceData(settings);
+	cityLoaded = true;
+
+	if constexpr (IsLogCategoryCompiled<LogOptions::DumpRegisteredOrdinances>())
+	{
+		Logger& logger = Logger::GetInstance();
+
+		if (logger.IsEnabled(LogOptions::DumpRegisteredOrdinances))
+		{
+			logger.WriteBlock(LogOptions::DumpRegisteredOrdinances, RegisteredOrdinanceDump::Format(city.OrdinanceSimulator(), ordinance));
+		}
+	}
+
+	return true;
+}
+
+void CityScenario::ShutdownCity()
+{
+	if (cityLoaded)
+	{
+		ordinance.PreCityShutdown(&city);
+		city.OrdinanceSimulator().RemoveOrdinance(ordinance);
+		cityLoaded = false;
+
+		Logger::GetInstance().Flush();
+		TraceEventRecorder::GetInstance().Flush();
+	}
+}
+
+int64_t CityScenario::SimulateMonth(uint32_t budgetPollCount)
+{
+	city.Simulator().AdvanceMonth();
+	++monthCount;
+
+	UpdatePopulation();
+
+	FakeOrdinanceSimulator& ordinanceSimulator = city.OrdinanceSimulator();
+
+	ordinanceSimulator.SimulateMonth();
+
+	const uint32_t clsid = ordinance.GetState().id;
+
+	if (ordinanceSimulator.IsOrdinanceAvailableButOff(clsid))
+	{
+		// The player enacts the ordinance as soon as it becomes available.
+		ordinanceSimulator.SetOrdinanceOn(clsid, true);
+	}
+
+	int64_t income = 0;
+
+	for (uint32_t i = 0; i < budgetPollCount; i++)
+	{
+		// The budget window queries both the current and the adjusted income
+		// every time it is repainted.
+		ordinance.GetCurrentMonthlyIncome();
+		income = ordinanceSimulator.GetOrdinanceMonthlyIncome();
+	}
+
+	return income;
+}
+
+FakeCity& CityScenario::City()
+{
+	return city;
+}
+
+uint64_t CityScenario::MonthCount() const
+{
+	return monthCount;
+}
+
+void CityScenario::UpdatePopulation()
+{
+	const float cycle = static_cast<float>(monthCount % kPopulationCycleMonths);
+
+	const float lowWealthPopulation = 2000.0f + (cycle * 40.0f);
+	const float medWealthPopulation = 1000.0f + (cycle * 25.0f);
+	const float highWealthPopulation = 500.0f + (cycle * 10.0f);
+
+	FakeDemandSimulator& demandSimulator = city.DemandSimulator();
+
+	demandSimulator.SetSupplyValue(kResidentialLowWealthGroupID, lowWealthPopulation);
+	demandSimulator.SetSupplyValue(kResidentialMedWealthGroupID, medWealthPopulation);
+	demandSimulator.SetSupplyValue(kResidentialHighWealthGroupID, highWealthPopulation);
+
+	city.ResidentialSimulator().SetPopulation(
+		static_cast<int32_t>(lowWealthPopulation + medWealthPopulation + highWealthPopulation));
+}
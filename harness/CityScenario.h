@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "FakeCity.h"
+
+class CityLotteryOrdinance;
+class ISettings;
+
+// Drives a FakeCity and the city lottery ordinance through the same sequence
+// of callbacks that the game uses: PostCityInit, the monthly ordinance update,
+// the budget window income queries and PreCityShutdown.
+class CityScenario
+{
+public:
+
+	CityScenario(CityLotteryOrdinance& ordinance, const ISettings& settings);
+
+	/**
+	 * @brief Loads the city and registers the ordinance with the ordinance simulator.
+	 * This mirrors CityLotteryOrdinanceDllDirector::PostCityInit.
+	 * @return True on success; otherwise, false.
+	*/
+	bool LoadCity();
+
+	/**
+	 * @brief Removes the ordinance and shuts down the city.
+	 * This mirrors CityLotteryOrdinanceDllDirector::PreCityShutdown.
+	*/
+	void ShutdownCity();
+
+	/**
+	 * @brief Advances the city by one month.
+	 * @param budgetPollCount The number of times the budget window queries
+	 * the ordinance income during the month.
+	 * @return The ordinance income for the month.
+	*/
+	int64_t SimulateMonth(uint32_t budgetPollCount);
+
+	FakeCity& City();
+
+	uint64_t MonthCount() const;
+
+private:
+
+	void UpdatePopulation();
+
+	CityLotteryOrdinance& ordinance;
+	const ISettings& settings;
+	FakeCity city;
+	uint64_t monthCount;
+	bool cityLoaded;
+};
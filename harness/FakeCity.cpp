@@ -0,0 +1,606 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "FakeCity.h"
+
+FakeCity::FakeCity()
+	: citySerialNumber(1),
+	  demandSimulator(),
+	  ordinanceSimulator(),
+	  residentialSimulator(),
+	  simulator(),
+	  refCount(0)
+{
+}
+
+FakeDemandSimulator& FakeCity::DemandSimulator()
+{
+	return demandSimulator;
+}
+
+FakeOrdinanceSimulator& FakeCity::OrdinanceSimulator()
+{
+	return ordinanceSimulator;
+}
+
+FakeResidentialSimulator& FakeCity::ResidentialSimulator()
+{
+	return residentialSimulator;
+}
+
+FakeSimulator& FakeCity::Simulator()
+{
+	return simulator;
+}
+
+bool FakeCity::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeCity::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeCity::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool FakeCity::Init()
+{
+	return true;
+}
+
+bool FakeCity::Shutdown()
+{
+	return true;
+}
+
+uint32_t FakeCity::GetCitySerialNumber()
+{
+	return citySerialNumber;
+}
+
+cISC4City* FakeCity::SetCitySerialNumber(uint32_t dwSerial)
+{
+	citySerialNumber = dwSerial;
+	return this;
+}
+
+cISC4Simulator* FakeCity::GetSimulator()
+{
+	return &simulator;
+}
+
+cISC4DemandSimulator* FakeCity::GetDemandSimulator()
+{
+	return &demandSimulator;
+}
+
+cISC4OrdinanceSimulator* FakeCity::GetOrdinanceSimulator()
+{
+	return &ordinanceSimulator;
+}
+
+cISC4ResidentialSimulator* FakeCity::GetResidentialSimulator()
+{
+	return &residentialSimulator;
+}
+
+uint32_t FakeCity::GetNewOccupantSerialNumber()
+{
+	return 0;
+}
+
+bool FakeCity::GetOriginalLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry)
+{
+	return false;
+}
+
+bool FakeCity::GetLastLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry)
+{
+	return false;
+}
+
+bool FakeCity::GetCitySaveFilePath(cIGZString& szPath)
+{
+	return false;
+}
+
+bool FakeCity::SetCitySaveFilePath(cIGZString const& szPath)
+{
+	return false;
+}
+
+bool FakeCity::GetCityName(cIGZString& szPath)
+{
+	return false;
+}
+
+bool FakeCity::SetCityName(cIGZString const& szPath)
+{
+	return false;
+}
+
+bool FakeCity::GetCityNameChanged()
+{
+	return false;
+}
+
+cISC4City* FakeCity::SetCityNameChanged(bool bToggle)
+{
+	return this;
+}
+
+bool FakeCity::GetMayorName(cIGZString& szName)
+{
+	return false;
+}
+
+bool FakeCity::SetMayorName(cIGZString const& szName)
+{
+	return false;
+}
+
+bool FakeCity::GetCityDescription(cIGZString& szDescription)
+{
+	return false;
+}
+
+bool FakeCity::SetCityDescription(cIGZString const& szDescription)
+{
+	return false;
+}
+
+uint32_t FakeCity::GetBirthDate()
+{
+	return 0;
+}
+
+cISC4City* FakeCity::SetBirthDate(uint32_t dwDate)
+{
+	return this;
+}
+
+bool FakeCity::GetEstablished()
+{
+	return false;
+}
+
+bool FakeCity::SetEstablished(bool bEstablished)
+{
+	return false;
+}
+
+int32_t FakeCity::GetDifficultyLevel()
+{
+	return 0;
+}
+
+cISC4City* FakeCity::SetDifficultyLevel(int32_t dwLevel)
+{
+	return this;
+}
+
+intptr_t FakeCity::GetWorldPosition(float& fX, float& fZ)
+{
+	return 0;
+}
+
+cISC4City* FakeCity::SetWorldPosition(float fX, float fZ)
+{
+	return this;
+}
+
+float FakeCity::GetWorldBaseElevation()
+{
+	return 0.0f;
+}
+
+cISC4City* FakeCity::SetWorldBaseElevation(float fElevation)
+{
+	return this;
+}
+
+int32_t FakeCity::GetWorldHemisphere()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetDemolitionUtility()
+{
+	return 0;
+}
+
+cISC4HistoryWarehouse* FakeCity::GetHistoryWarehouse()
+{
+	return nullptr;
+}
+
+cISC4LotManager* FakeCity::GetLotManager()
+{
+	return nullptr;
+}
+
+cISC4OccupantManager* FakeCity::GetOccupantManager()
+{
+	return nullptr;
+}
+
+intptr_t FakeCity::GetPropManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetZoneManager()
+{
+	return 0;
+}
+
+cISC4LotConfigurationManager* FakeCity::GetLotConfigurationManager()
+{
+	return nullptr;
+}
+
+cISC4NetworkManager* FakeCity::GetNetworkManager()
+{
+	return nullptr;
+}
+
+intptr_t FakeCity::GetDispatchManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetTrafficNetwork()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetPropDeveloper()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetNetworkLotManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetVehicleManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetPedestrianManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetAircraftManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetWatercraftManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetAutomataControllerManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetAutomataScriptSystem()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetCitySituationManager()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetAuraSimulator()
+{
+	return 0;
+}
+
+cISC4BudgetSimulator* FakeCity::GetBudgetSimulator()
+{
+	return nullptr;
+}
+
+cISC4BuildingDevelopmentSimulator* FakeCity::GetBuildingDevelopmentSimulator()
+{
+	return nullptr;
+}
+
+intptr_t FakeCity::GetCommercialSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetCrimeSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetFireProtectionSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetFlammabilitySimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetFloraSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetIndustrialSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetLandValueSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetNeighborsSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetPlumbingSimulator()
+{
+	return 0;
+}
+
+cISC4PoliceSimulator* FakeCity::GetPoliceSimulator()
+{
+	return nullptr;
+}
+
+cISC4PollutionSimulator* FakeCity::GetPollutionSimulator()
+{
+	return nullptr;
+}
+
+intptr_t FakeCity::GetPowerSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetTrafficSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetWeatherSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetMySimAgentSimulator()
+{
+	return 0;
+}
+
+cISC4DisasterLayer* FakeCity::GetDisasterLayer()
+{
+	return nullptr;
+}
+
+intptr_t FakeCity::GetCivicBuildingSimulator()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetParkManager()
+{
+	return 0;
+}
+
+cISC4LotManager* FakeCity::GetZoneDeveloper()
+{
+	return nullptr;
+}
+
+intptr_t FakeCity::GetSeaportDeveloper()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetAirportDeveloper()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetLandfillDeveloper()
+{
+	return 0;
+}
+
+cISC4LotDeveloper* FakeCity::GetLotDeveloper()
+{
+	return nullptr;
+}
+
+cISC4TractDeveloper* FakeCity::GetTractDeveloper()
+{
+	return nullptr;
+}
+
+cISC4AdvisorSystem* FakeCity::GetAdvisorSystem()
+{
+	return nullptr;
+}
+
+cISC4TutorialSystem* FakeCity::GetTutorialSystem()
+{
+	return nullptr;
+}
+
+intptr_t FakeCity::GetSurfaceWater()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetTerrain()
+{
+	return 0;
+}
+
+intptr_t FakeCity::GetEffectsManager()
+{
+	return 0;
+}
+
+cISC424HourClock* FakeCity::Get24HourClock()
+{
+	return nullptr;
+}
+
+uint32_t FakeCity::GetCitySizeType()
+{
+	return 0;
+}
+
+bool FakeCity::SetSize(float fX, float fZ)
+{
+	return false;
+}
+
+float FakeCity::SizeX()
+{
+	return 0.0f;
+}
+
+float FakeCity::SizeZ()
+{
+	return 0.0f;
+}
+
+float FakeCity::CellWidthX()
+{
+	return 0.0f;
+}
+
+float FakeCity::CellWidthZ()
+{
+	return 0.0f;
+}
+
+uint32_t FakeCity::CellCountX()
+{
+	return 0;
+}
+
+uint32_t FakeCity::CellCountZ()
+{
+	return 0;
+}
+
+int32_t FakeCity::PositionToCell(float fX, float fZ, int& cX, int& cZ)
+{
+	return 0;
+}
+
+int32_t FakeCity::CellCornerToPosition(int cX, int cZ, float& fX, float& fZ)
+{
+	return 0;
+}
+
+int32_t FakeCity::CellCenterToPosition(int cX, int cZ, float& fX, float& fZ)
+{
+	return 0;
+}
+
+bool FakeCity::LocationIsInBounds(float fX, float fZ)
+{
+	return false;
+}
+
+bool FakeCity::CellIsInBounds(int cX, int cZ)
+{
+	return false;
+}
+
+bool FakeCity::CellCornerIsInBounds(int cX, int cZ)
+{
+	return false;
+}
+
+void FakeCity::ToggleSimulationMode()
+{
+}
+
+bool FakeCity::IsInCityTimeSimulationMode()
+{
+	return false;
+}
+
+int32_t FakeCity::EnableSave()
+{
+	return 0;
+}
+
+int32_t FakeCity::DisableSave()
+{
+	return 0;
+}
+
+bool FakeCity::IsSaveDisabled()
+{
+	return false;
+}
+
+cISC4City* FakeCity::UIIncreaseLockCount()
+{
+	return this;
+}
+
+int32_t FakeCity::UIDecreaseLockCount()
+{
+	return 0;
+}
+
+int32_t FakeCity::UIGetLockCount()
+{
+	return 0;
+}
+
+bool FakeCity::SaveObliterated(cIGZPersistDBSegment* pSegment)
+{
+	return false;
+}
@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4City.h"
+#include "FakeDemandSimulator.h"
+#include "FakeOrdinanceSimulator.h"
+#include "FakeResidentialSimulator.h"
+#include "FakeSimulator.h"
+
+// A stand-in for the game's cISC4City.
+// Only the simulators that are used by the ordinance code are provided,
+// the other accessors return null or default values.
+class FakeCity final : public cISC4City
+{
+public:
+
+	FakeCity();
+
+	FakeDemandSimulator& DemandSimulator();
+	FakeOrdinanceSimulator& OrdinanceSimulator();
+	FakeResidentialSimulator& ResidentialSimulator();
+	FakeSimulator& Simulator();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init() override;
+	bool Shutdown() override;
+
+	uint32_t GetCitySerialNumber() override;
+	cISC4City* SetCitySerialNumber(uint32_t dwSerial) override;
+	uint32_t GetNewOccupantSerialNumber() override;
+
+	bool GetOriginalLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry) override;
+	bool GetLastLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry) override;
+
+	bool GetCitySaveFilePath(cIGZString& szPath) override;
+	bool SetCitySaveFilePath(cIGZString const& szPath) override;
+
+	bool GetCityName(cIGZString& szPath) override;
+	bool SetCityName(cIGZString const& szPath) override;
+
+	bool GetCityNameChanged() override;
+	cISC4City* SetCityNameChanged(bool bToggle) override;
+
+	bool GetMayorName(cIGZString& szName) override;
+	bool SetMayorName(cIGZString const& szName) override;
+
+	bool GetCityDescription(cIGZString& szDescription) override;
+	bool SetCityDescription(cIGZString const& szDescription) override;
+
+	uint32_t GetBirthDate() override;
+	cISC4City* SetBirthDate(uint32_t dwDate) override;
+
+	bool GetEstablished() override;
+	bool SetEstablished(bool bEstablished) override;
+
+	int32_t GetDifficultyLevel() override;
+	cISC4City* SetDifficultyLevel(int32_t dwLevel) override;
+
+	intptr_t GetWorldPosition(float& fX, float& fZ) override;
+	cISC4City* SetWorldPosition(float fX, float fZ) override;
+
+	float GetWorldBaseElevation() override;
+	cISC4City* SetWorldBaseElevation(float fElevation) override;
+
+	int32_t GetWorldHemisphere() override;
+
+	// intptr_t's are class instances that have yet to be discerned
+	intptr_t GetDemolitionUtility() override;
+	cISC4HistoryWarehouse* GetHistoryWarehouse() override;
+	cISC4LotManager* GetLotManager() override;
+	cISC4OccupantManager* GetOccupantManager() override;
+	intptr_t GetPropManager() override;
+	intptr_t GetZoneManager() override;
+	cISC4LotConfigurationManager* GetLotConfigurationManager() override;
+	cISC4NetworkManager* GetNetworkManager() override;
+	intptr_t GetDispatchManager() override;
+	intptr_t GetTrafficNetwork() override;
+	intptr_t GetPropDeveloper() override;
+	intptr_t GetNetworkLotManager() override;
+	intptr_t GetVehicleManager() override;
+	intptr_t GetPedestrianManager() override;
+	intptr_t GetAircraftManager() override;
+	intptr_t GetWatercraftManager() override;
+	intptr_t GetAutomataControllerManager() override;
+	intptr_t GetAutomataScriptSystem() override;
+	intptr_t GetCitySituationManager() override;
+
+	cISC4Simulator* GetSimulator() override;
+	intptr_t GetAuraSimulator() override;
+	cISC4BudgetSimulator* GetBudgetSimulator() override;
+	cISC4BuildingDevelopmentSimulator* GetBuildingDevelopmentSimulator() override;
+	intptr_t GetCommercialSimulator() override;
+	intptr_t GetCrimeSimulator() override;
+	cISC4DemandSimulator* GetDemandSimulator() override;
+	intptr_t GetFireProtectionSimulator() override;
+	intptr_t GetFlammabilitySimulator() override;
+	intptr_t GetFloraSimulator() override;
+	intptr_t GetIndustrialSimulator() override;
+	intptr_t GetLandValueSimulator() override;
+	intptr_t GetNeighborsSimulator() override;
+	cISC4OrdinanceSimulator* GetOrdinanceSimulator() override;
+	intptr_t GetPlumbingSimulator() override;
+	cISC4PoliceSimulator* GetPoliceSimulator() override;
+	cISC4PollutionSimulator* GetPollutionSimulator() override;
+	intptr_t GetPowerSimulator() override;
+	cISC4ResidentialSimulator* GetResidentialSimulator() override;
+	intptr_t GetTrafficSimulator() override;
+	intptr_t GetWeatherSimulator() override;
+	intptr_t GetMySimAgentSimulator() override;
+
+	cISC4DisasterLayer* GetDisasterLayer() override;
+	intptr_t GetCivicBuildingSimulator() override;
+	intptr_t GetParkManager() override;
+	cISC4LotManager* GetZoneDeveloper() override;
+	intptr_t GetSeaportDeveloper() override;
+	intptr_t GetAirportDeveloper() override;
+	intptr_t GetLandfillDeveloper() override;
+	cISC4LotDeveloper* GetLotDeveloper() override;
+	cISC4TractDeveloper* GetTractDeveloper() override;
+
+	cISC4AdvisorSystem* GetAdvisorSystem() override;
+	cISC4TutorialSystem* GetTutorialSystem() override;
+
+	intptr_t GetSurfaceWater() override;
+	intptr_t GetTerrain() override;
+
+	intptr_t GetEffectsManager() override;
+
+	cISC424HourClock* Get24HourClock() override;
+
+	uint32_t GetCitySizeType() override;
+	bool SetSize(float fX, float fZ) override;
+	float SizeX() override;
+	float SizeZ() override;
+
+	float CellWidthX() override;
+	float CellWidthZ() override;
+
+	uint32_t CellCountX() override;
+	uint32_t CellCountZ() override;
+
+	int32_t PositionToCell(float fX, float fZ, int& cX, int& cZ) override;
+	int32_t CellCornerToPosition(int cX, int cZ, float& fX, float& fZ) override;
+	int32_t CellCenterToPosition(int cX, int cZ, float& fX, float& fZ) override;
+
+	bool LocationIsInBounds(float fX, float fZ) override;
+	bool CellIsInBounds(int cX, int cZ) override;
+	bool CellCornerIsInBounds(int cX, int cZ) override;
+
+	void ToggleSimulationMode() override;
+	bool IsInCityTimeSimulationMode() override;
+
+	int32_t EnableSave() override;
+	int32_t DisableSave() override;
+	bool IsSaveDisabled() override;
+
+	cISC4City* UIIncreaseLockCount() override;
+	int32_t UIDecreaseLockCount() override;
+	int32_t UIGetLockCount() override;
+
+	bool SaveObliterated(cIGZPersistDBSegment* pSegment) override;
+
+private:
+
+	uint32_t citySerialNumber;
+	FakeDemandSimulator demandSimulator;
+	FakeOrdinanceSimulator ordinanceSimulator;
+	FakeResidentialSimulator residentialSimulator;
+	FakeSimulator simulator;
+	uint32_t refCount;
+};
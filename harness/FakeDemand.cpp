@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "FakeDemand.h"
+
+FakeDemand::FakeDemand(uint32_t id)
+	: id(id),
+	  supplyValue(0.0f),
+	  demandValue(0.0f),
+	  activeDemandMax(0.0f),
+	  activeDemandMin(0.0f),
+	  taxModifier(1.0f),
+	  refCount(0)
+{
+}
+
+bool FakeDemand::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeDemand::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeDemand::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool FakeDemand::Init()
+{
+	return true;
+}
+
+bool FakeDemand::Shutdown()
+{
+	return true;
+}
+
+bool FakeDemand::SimulationBegin()
+{
+	return true;
+}
+
+uint32_t FakeDemand::GetId() const
+{
+	return id;
+}
+
+bool FakeDemand::SetId(uint32_t id)
+{
+	this->id = id;
+	return true;
+}
+
+float FakeDemand::QuerySupplyValue() const
+{
+	return supplyValue;
+}
+
+float FakeDemand::QueryDemandValue() const
+{
+	return demandValue;
+}
+
+float FakeDemand::QueryNewSupply() const
+{
+	return 0.0f;
+}
+
+float FakeDemand::QueryNewDemand() const
+{
+	return 0.0f;
+}
+
+float FakeDemand::QueryActiveDemandValue() const
+{
+	return demandValue;
+}
+
+float FakeDemand::QueryEconomyModifier() const
+{
+	return 1.0f;
+}
+
+float FakeDemand::QueryActiveDemandMax() const
+{
+	return activeDemandMax;
+}
+
+float FakeDemand::QueryActiveDemandMin() const
+{
+	return activeDemandMin;
+}
+
+bool FakeDemand::AddToSupplyValue(float value)
+{
+	supplyValue += value;
+	return true;
+}
+
+bool FakeDemand::AddToDemandValue(float value)
+{
+	demandValue += value;
+	return true;
+}
+
+bool FakeDemand::SetSupplyValue(float value)
+{
+	supplyValue = value;
+	return true;
+}
+
+bool FakeDemand::SetDemandValue(float value)
+{
+	demandValue = value;
+	return true;
+}
+
+bool FakeDemand::SetActiveDemandMax(float value)
+{
+	activeDemandMax = value;
+	return true;
+}
+
+bool FakeDemand::SetActiveDemandMin(float value)
+{
+	activeDemandMin = value;
+	return true;
+}
+
+float FakeDemand::GetEconomyModifier() const
+{
+	return 1.0f;
+}
+
+bool FakeDemand::SetEconomyModifier()
+{
+	return false;
+}
+
+float FakeDemand::GetTaxModifier() const
+{
+	return taxModifier;
+}
+
+bool FakeDemand::SetTaxModifier(float value)
+{
+	taxModifier = value;
+	return true;
+}
+
+SC4Percentage* FakeDemand::GetDemandCap() const
+{
+	return nullptr;
+}
+
+bool FakeDemand::SetDemandCap(const SC4Percentage& demandCap)
+{
+	return false;
+}
+
+uint32_t FakeDemand::GetRegionUse()
+{
+	return 0;
+}
+
+bool FakeDemand::SetRegionUse(uint32_t param_1)
+{
+	return false;
+}
+
+float FakeDemand::EndOfCycle()
+{
+	return 0.0f;
+}
+
+void FakeDemand::DebugLockValue(float value)
+{
+}
+
+void FakeDemand::DebugUnlockValue()
+{
+}
+
+bool FakeDemand::DebugIsValueLocked()
+{
+	return false;
+}
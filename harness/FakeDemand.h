@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4Demand.h"
+
+// A stand-in for a single demand/census entry in the game's demand simulator.
+class FakeDemand final : public cISC4Demand
+{
+public:
+
+	FakeDemand(uint32_t id);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init() override;
+	bool Shutdown() override;
+	bool SimulationBegin() override;
+
+	uint32_t GetId() const override;
+	bool SetId(uint32_t id) override;
+
+	float QuerySupplyValue() const override;
+	float QueryDemandValue() const override;
+	float QueryNewSupply() const override;
+	float QueryNewDemand() const override;
+	float QueryActiveDemandValue() const override;
+	float QueryEconomyModifier() const override;
+	float QueryActiveDemandMax() const override;
+	float QueryActiveDemandMin() const override;
+
+	bool AddToSupplyValue(float value) override;
+	bool AddToDemandValue(float value) override;
+
+	bool SetSupplyValue(float value) override;
+	bool SetDemandValue(float value) override;
+
+	bool SetActiveDemandMax(float value) override;
+	bool SetActiveDemandMin(float value) override;
+
+	float GetEconomyModifier() const override;
+	bool SetEconomyModifier() override;
+
+	float GetTaxModifier() const override;
+	bool SetTaxModifier(float value) override;
+
+	SC4Percentage* GetDemandCap() const override;
+	bool SetDemandCap(const SC4Percentage& demandCap) override;
+
+	uint32_t GetRegionUse() override;
+	bool SetRegionUse(uint32_t param_1) override;
+
+	float EndOfCycle() override;
+
+	void DebugLockValue(float value) override;
+	void DebugUnlockValue() override;
+	bool DebugIsValueLocked() override;
+
+private:
+
+	uint32_t id;
+	float supplyValue;
+	float demandValue;
+	float activeDemandMax;
+	float activeDemandMin;
+	float taxModifier;
+	uint32_t refCount;
+};
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "FakeDemandSimulator.h"
+#include "SC4Percentage.h"
+
+FakeDemandSimulator::FakeDemandSimulator()
+	: demands(),
+	  getDemandCallCount(0),
+	  refCount(0)
+{
+}
+
+void FakeDemandSimulator::SetSupplyValue(uint32_t demandID, float value)
+{
+	auto it = demands.try_emplace(demandID, demandID).first;
+
+	it->second.SetSupplyValue(value);
+}
+
+uint64_t FakeDemandSimulator::GetDemandCallCount() const
+{
+	return getDemandCallCount;
+}
+
+bool FakeDemandSimulator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeDemandSimulator::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeDemandSimulator::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool FakeDemandSimulator::Init()
+{
+	return true;
+}
+
+bool FakeDemandSimulator::Shutdown()
+{
+	return true;
+}
+
+uint32_t FakeDemandSimulator::GetSimulatorType()
+{
+	return 0;
+}
+
+cISC4Demand* FakeDemandSimulator::GetDemand(uint32_t demandID, uint32_t demandIndex)
+{
+	++getDemandCallCount;
+
+	if (demandIndex == 0)
+	{
+		auto it = demands.find(demandID);
+
+		if (it != demands.end())
+		{
+			return &it->second;
+		}
+	}
+
+	return nullptr;
+}
+
+void FakeDemandSimulator::UpdateOccupantEffects(SC4Percentage unknown1, SC4Percentage const& unknown2, SC4Percentage const& unknown3)
+{
+}
+
+void FakeDemandSimulator::CalculateJobsPerUnitOfDemand(float* jobsArray, uint32_t exemplarInstanceLow, uint32_t exemplarInstanceHigh)
+{
+}
+
+uint32_t FakeDemandSimulator::GetJobsBySensus(uint32_t type)
+{
+	return 0;
+}
+
+float FakeDemandSimulator::GetNeutralTaxRate()
+{
+	return 9.0f;
+}
+
+void FakeDemandSimulator::GetLocalPopulationSummary(std::map<uint32_t, int32_t>& map) const
+{
+	map.clear();
+
+	for (const auto& item : demands)
+	{
+		map.emplace(item.first, static_cast<int32_t>(item.second.QuerySupplyValue()));
+	}
+}
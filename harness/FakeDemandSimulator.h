@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4DemandSimulator.h"
+#include "FakeDemand.h"
+#include <map>
+
+// A stand-in for the game's cISC4DemandSimulator.
+// Only the city census (demand index 0) is modeled.
+class FakeDemandSimulator final : public cISC4DemandSimulator
+{
+public:
+
+	FakeDemandSimulator();
+
+	/**
+	 * @brief Sets the supply value (population or jobs) of the specified demand group.
+	 * @param demandID The demand group ID, e.g. 0x1011 for R$.
+	 * @param value The new supply value.
+	*/
+	void SetSupplyValue(uint32_t demandID, float value);
+
+	/**
+	 * @brief Gets the number of GetDemand calls that have been made.
+	 * @return The number of GetDemand calls that have been made.
+	*/
+	uint64_t GetDemandCallCount() const;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init() override;
+	bool Shutdown() override;
+	uint32_t GetSimulatorType() override;
+
+	cISC4Demand* GetDemand(uint32_t demandID, uint32_t demandIndex) override;
+	void UpdateOccupantEffects(SC4Percentage unknown1, SC4Percentage const& unknown2, SC4Percentage const& unknown3) override;
+
+	void CalculateJobsPerUnitOfDemand(float* jobsArray, uint32_t exemplarInstanceLow, uint32_t exemplarInstanceHigh) override;
+
+	uint32_t GetJobsBySensus(uint32_t type) override;
+
+	float GetNeutralTaxRate() override;
+	void GetLocalPopulationSummary(std::map<uint32_t, int32_t>& map) const override;
+
+private:
+
+	std::map<uint32_t, FakeDemand> demands;
+	uint64_t getDemandCallCount;
+	uint32_t refCount;
+};
@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "FakeOrdinanceSimulator.h"
+#include "cIGZString.h"
+#include "cISC4Ordinance.h"
+#include <algorithm>
+
+namespace
+{
+	template<typename Predicate>
+	uint32_t CopyOrdinanceIDs(
+		const std::vector<cISC4Ordinance*>& ordinances,
+		uint32_t* pCLSIDsOut,
+		uint32_t& dwCountOut,
+		Predicate predicate)
+	{
+		const uint32_t capacity = pCLSIDsOut ? dwCountOut : 0;
+		uint32_t count = 0;
+
+		for (cISC4Ordinance* pOrdinance : ordinances)
+		{
+			if (predicate(pOrdinance))
+			{
+				if (count < capacity)
+				{
+					pCLSIDsOut[count] = pOrdinance->GetID();
+				}
+
+				++count;
+			}
+		}
+
+		dwCountOut = pCLSIDsOut ? std::min(count, capacity) : count;
+
+		return count;
+	}
+}
+
+FakeOrdinanceSimulator::FakeOrdinanceSimulator()
+	: ordinances(),
+	  refCount(0)
+{
+}
+
+void FakeOrdinanceSimulator::SimulateMonth()
+{
+	for (cISC4Ordinance* pOrdinance : ordinances)
+	{
+		if (!pOrdinance->IsAvailable() && pOrdinance->CheckConditions())
+		{
+			pOrdinance->SetAvailable(true);
+		}
+
+		if (pOrdinance->IsOn())
+		{
+			pOrdinance->Simulate();
+		}
+	}
+}
+
+bool FakeOrdinanceSimulator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeOrdinanceSimulator::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeOrdinanceSimulator::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool FakeOrdinanceSimulator::Init()
+{
+	return true;
+}
+
+bool FakeOrdinanceSimulator::Shutdown()
+{
+	for (cISC4Ordinance* pOrdinance : ordinances)
+	{
+		pOrdinance->Release();
+	}
+
+	ordinances.clear();
+	return true;
+}
+
+bool FakeOrdinanceSimulator::AddOrdinance(cISC4Ordinance& ordinance)
+{
+	if (GetOrdinanceByID(ordinance.GetID()))
+	{
+		return false;
+	}
+
+	ordinance.AddRef();
+	ordinances.push_back(&ordinance);
+	return true;
+}
+
+bool FakeOrdinanceSimulator::RemoveOrdinance(cISC4Ordinance& ordinance)
+{
+	auto it = std::find(ordinances.begin(), ordinances.end(), &ordinance);
+
+	if (it != ordinances.end())
+	{
+		ordinances.erase(it);
+		ordinance.Release();
+		return true;
+	}
+
+	return false;
+}
+
+bool FakeOrdinanceSimulator::IsOrdinanceAvailable(uint32_t clsid)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByID(clsid);
+
+	return pOrdinance && pOrdinance->IsAvailable();
+}
+
+bool FakeOrdinanceSimulator::IsOrdinanceOn(uint32_t clsid)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByID(clsid);
+
+	return pOrdinance && pOrdinance->IsOn();
+}
+
+bool FakeOrdinanceSimulator::IsOrdinanceAvailableButOff(uint32_t clsid)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByID(clsid);
+
+	return pOrdinance && pOrdinance->IsAvailable() && !pOrdinance->IsOn();
+}
+
+bool FakeOrdinanceSimulator::SetOrdinanceAvailable(uint32_t clsid, bool available)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByID(clsid);
+
+	return pOrdinance && pOrdinance->SetAvailable(available);
+}
+
+uint32_t FakeOrdinanceSimulator::GetOrdinanceAvailableCount()
+{
+	uint32_t count = 0;
+
+	return CopyOrdinanceIDs(ordinances, nullptr, count, [](cISC4Ordinance* pOrdinance) { return pOrdinance->IsAvailable(); });
+}
+
+uint32_t FakeOrdinanceSimulator::GetOrdinanceAvailableArray(uint32_t* pCLSIDsOut, uint32_t& dwCountOut)
+{
+	return CopyOrdinanceIDs(ordinances, pCLSIDsOut, dwCountOut, [](cISC4Ordinance* pOrdinance) { return pOrdinance->IsAvailable(); });
+}
+
+bool FakeOrdinanceSimulator::SetOrdinanceOn(uint32_t clsid, bool on)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByID(clsid);
+
+	return pOrdinance && pOrdinance->SetOn(on);
+}
+
+uint32_t FakeOrdinanceSimulator::GetOrdinanceOnCount()
+{
+	uint32_t count = 0;
+
+	return CopyOrdinanceIDs(ordinances, nullptr, count, [](cISC4Ordinance* pOrdinance) { return pOrdinance->IsOn(); });
+}
+
+uint32_t FakeOrdinanceSimulator::GetOrdinanceOnArray(uint32_t* pCLSIDsOut, uint32_t& dwCountOut)
+{
+	return CopyOrdinanceIDs(ordinances, pCLSIDsOut, dwCountOut, [](cISC4Ordinance* pOrdinance) { return pOrdinance->IsOn(); });
+}
+
+bool FakeOrdinanceSimulator::IsOrdinanceEnabled(uint32_t clsid)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByID(clsid);
+
+	return pOrdinance && pOrdinance->IsEnabled();
+}
+
+bool FakeOrdinanceSimulator::SetOrdinanceEnabled(uint32_t clsid, bool enabled)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByID(clsid);
+
+	return pOrdinance && pOrdinance->SetEnabled(enabled);
+}
+
+uint32_t FakeOrdinanceSimulator::GetOrdinanceIDArray(uint32_t* pCLSIDsOut, uint32_t& dwCountOut)
+{
+	return CopyOrdinanceIDs(ordinances, pCLSIDsOut, dwCountOut, [](cISC4Ordinance*) { return true; });
+}
+
+uint32_t FakeOrdinanceSimulator::GetOrdinanceIDByName(cIGZString const& name)
+{
+	cISC4Ordinance* pOrdinance = GetOrdinanceByName(name);
+
+	return pOrdinance ? pOrdinance->GetID() : 0;
+}
+
+cISC4Ordinance* FakeOrdinanceSimulator::GetOrdinanceByID(uint32_t clsid)
+{
+	for (cISC4Ordinance* pOrdinance : ordinances)
+	{
+		if (pOrdinance->GetID() == clsid)
+		{
+			return pOrdinance;
+		}
+	}
+
+	return nullptr;
+}
+
+cISC4Ordinance* FakeOrdinanceSimulator::GetOrdinanceByName(cIGZString const& name)
+{
+	for (cISC4Ordinance* pOrdinance : ordinances)
+	{
+		cIGZString* ordinanceName = pOrdinance->GetName();
+
+		if (ordinanceName && ordinanceName->IsEqual(name, false))
+		{
+			return pOrdinance;
+		}
+	}
+
+	return nullptr;
+}
+
+int64_t FakeOrdinanceSimulator::GetOrdinanceMonthlyExpense()
+{
+	int64_t total = 0;
+
+	for (cISC4Ordinance* pOrdinance : ordinances)
+	{
+		if (pOrdinance->IsOn() && !pOrdinance->IsIncomeOrdinance())
+		{
+			total += pOrdinance->GetMonthlyAdjustedIncome();
+		}
+	}
+
+	return total;
+}
+
+int64_t FakeOrdinanceSimulator::GetOrdinanceMonthlyIncome()
+{
+	int64_t total = 0;
+
+	for (cISC4Ordinance* pOrdinance : ordinances)
+	{
+		if (pOrdinance->IsOn() && pOrdinance->IsIncomeOrdinance())
+		{
+			total += pOrdinance->GetMonthlyAdjustedIncome();
+		}
+	}
+
+	return total;
+}
+
+int64_t FakeOrdinanceSimulator::GetCumulativeOffset(uint32_t unknown1, uint32_t unknown2)
+{
+	return 0;
+}
+
+float FakeOrdinanceSimulator::GetCumulativeFactor(uint32_t unknown1, uint32_t unknown2)
+{
+	return 1.0f;
+}
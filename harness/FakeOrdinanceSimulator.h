@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4OrdinanceSimulator.h"
+#include <vector>
+
+// A stand-in for the game's cISC4OrdinanceSimulator.
+// The monthly ordinance update is driven explicitly by calling SimulateMonth.
+class FakeOrdinanceSimulator final : public cISC4OrdinanceSimulator
+{
+public:
+
+	FakeOrdinanceSimulator();
+
+	/**
+	 * @brief Runs the monthly update for all of the registered ordinances.
+	 *
+	 * The update mirrors the order used by the game: CheckConditions is used
+	 * to make an ordinance available, and ordinances that are enacted are
+	 * asked to run their monthly simulation.
+	*/
+	void SimulateMonth();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init() override;
+	bool Shutdown() override;
+
+	bool AddOrdinance(cISC4Ordinance& ordinance) override;
+	bool RemoveOrdinance(cISC4Ordinance& ordinance) override;
+
+	bool IsOrdinanceAvailable(uint32_t clsid) override;
+	bool IsOrdinanceOn(uint32_t clsid) override;
+	bool IsOrdinanceAvailableButOff(uint32_t clsid) override;
+
+	bool SetOrdinanceAvailable(uint32_t clsid, bool available) override;
+	uint32_t GetOrdinanceAvailableCount() override;
+	uint32_t GetOrdinanceAvailableArray(uint32_t* pCLSIDsOut, uint32_t& dwCountOut) override;
+
+	bool SetOrdinanceOn(uint32_t clsid, bool on) override;
+	uint32_t GetOrdinanceOnCount() override;
+	uint32_t GetOrdinanceOnArray(uint32_t* pCLSIDsOut, uint32_t& dwCountOut) override;
+
+	bool IsOrdinanceEnabled(uint32_t clsid) override;
+	bool SetOrdinanceEnabled(uint32_t clsid, bool enabled) override;
+
+	uint32_t GetOrdinanceIDArray(uint32_t* pCLSIDsOut, uint32_t& dwCountOut) override;
+	uint32_t GetOrdinanceIDByName(cIGZString const& name) override;
+
+	cISC4Ordinance* GetOrdinanceByID(uint32_t clsid) override;
+	cISC4Ordinance* GetOrdinanceByName(cIGZString const& name) override;
+
+	int64_t GetOrdinanceMonthlyExpense() override;
+	int64_t GetOrdinanceMonthlyIncome() override;
+
+	int64_t GetCumulativeOffset(uint32_t unknown1, uint32_t unknown2) override;
+	float GetCumulativeFactor(uint32_t unknown1, uint32_t unknown2) override;
+
+private:
+
+	std::vector<cISC4Ordinance*> ordinances;
+	uint32_t refCount;
+};
@@ -0,0 +1,336 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "FakeResidentialSimulator.h"
+
+FakeResidentialSimulator::FakeResidentialSimulator()
+	: population(0),
+	  refCount(0)
+{
+}
+
+void FakeResidentialSimulator::SetPopulation(int32_t value)
+{
+	population = value;
+}
+
+bool FakeResidentialSimulator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeResidentialSimulator::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeResidentialSimulator::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool FakeResidentialSimulator::Init()
+{
+	return true;
+}
+
+bool FakeResidentialSimulator::Shutdown()
+{
+	return true;
+}
+
+int32_t FakeResidentialSimulator::GetPopulation()
+{
+	return population;
+}
+
+intptr_t FakeResidentialSimulator::GetProximityMap(uint8_t cWealthType)
+{
+	return 0;
+}
+
+bool FakeResidentialSimulator::SchoolIsOnStrike()
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::HealthIsOnStrike()
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::EndSchoolStrike()
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::EndHealthStrike()
+{
+	return false;
+}
+
+float FakeResidentialSimulator::ChanceOfSchoolStrike()
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::ChanceOfHealthStrike()
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetSchoolSystemRating()
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetHealthSystemRating()
+{
+	return 0.0f;
+}
+
+bool FakeResidentialSimulator::GetSchoolSystemTotals(std::list<int32_t> const& sData)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetHospitalSystemTotals(std::list<int32_t> const& sData)
+{
+	return false;
+}
+
+int32_t FakeResidentialSimulator::GetTotalCityEducationUpkeepCost()
+{
+	return 0;
+}
+
+int32_t FakeResidentialSimulator::GetTotalCityHealthUpkeepCost()
+{
+	return 0;
+}
+
+bool FakeResidentialSimulator::SetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage const& sSchoolFunding, SC4Percentage const& sHealthFunding, bool bUnknown)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage& sSchoolFunding, SC4Percentage& sHealthFunding, bool bUnknown)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetAverageEQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetAverageHQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetEQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetHQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetPopulationGrids(cISC4SimGrid<uint16_t>*& pGrid, cISC4SimGrid<uint16_t>* pUnknown1, cISC4SimGrid<uint16_t>* pUnknown2)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetSchoolQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetHospitalQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::EstimateCurrentOccupantCapacity(cISC4Occupant* pOccupant, uint32_t& dwUnknown1, uint32_t& dwUnknown2)
+{
+	return false;
+}
+
+int32_t FakeResidentialSimulator::GetCellLifeExpectancy(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return 0;
+}
+
+float FakeResidentialSimulator::GetCellWorkforcePercent(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetGlobalWorkforcePercent()
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetGlobalEQ()
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetGlobalHQ()
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetGlobalLE()
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetCellEQ(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetCellHQ(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetCellEQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType)
+{
+	return 0.0f;
+}
+
+float FakeResidentialSimulator::GetCellHQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType)
+{
+	return 0.0f;
+}
+
+int32_t FakeResidentialSimulator::GetSchoolAverageGradeMap()
+{
+	return 0;
+}
+
+int32_t FakeResidentialSimulator::GetHospitalAverageGradeMap()
+{
+	return 0;
+}
+
+int32_t FakeResidentialSimulator::GetAverageAgeMap()
+{
+	return 0;
+}
+
+int32_t FakeResidentialSimulator::GetAverageNewAgeByWealth(uint8_t cWealthType)
+{
+	return 0;
+}
+
+bool FakeResidentialSimulator::GetEQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetHQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetOccupantCoverage(cISC4Occupant* pOccupant, SC4Percentage const& sEffectiveness, float& fRangeX, float& fRangeZ)
+{
+	return false;
+}
+
+int32_t FakeResidentialSimulator::GetSchoolBuildingCount()
+{
+	return 0;
+}
+
+bool FakeResidentialSimulator::GetSchoolBuildings(std::list<cISC4Occupant*>& sBuildings, std::vector<uint32_t>& sUnknown)
+{
+	return false;
+}
+
+int32_t FakeResidentialSimulator::GetHospitalBuildingCount()
+{
+	return 0;
+}
+
+bool FakeResidentialSimulator::GetHospitalBuildings(std::list<cISC4Occupant*>& sBuildings, std::vector<uint32_t>& sUnknown)
+{
+	return false;
+}
+
+int32_t FakeResidentialSimulator::GetMaxEQ()
+{
+	return 0;
+}
+
+int32_t FakeResidentialSimulator::GetMaxHQ()
+{
+	return 0;
+}
+
+bool FakeResidentialSimulator::GetGlobalAutoBudgetForSchools()
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::SetGlobalAutoBudgetForSchools(bool bEnable)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetGlobalAutoBudgetForHospitals()
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::SetGlobalAutoBudgetForHospitals(bool bEnable)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::GetAutoBudget()
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::SetAutoBudget(bool bEnable)
+{
+	return false;
+}
+
+bool FakeResidentialSimulator::EstimateIdealFunding(cISC4Occupant* pOccupant, SC4Percentage& sFunding)
+{
+	return false;
+}
+
+void FakeResidentialSimulator::ToggleTractTracking(int32_t nUnknown1, int32_t nUnknown2)
+{
+}
@@ -0,0 +1,323 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "FakeSimDate.h"
+
+static constexpr uint32_t kDaysPerMonth = 30;
+static constexpr uint32_t kMonthsPerYear = 12;
+static constexpr uint32_t kDaysPerYear = kDaysPerMonth * kMonthsPerYear;
+
+// The in-game date starts in the year 2000.
+static constexpr uint32_t kStartYear = 2000;
+
+FakeSimDate::FakeSimDate()
+	: dayNumber(kStartYear * kDaysPerYear),
+	  refCount(0)
+{
+}
+
+void FakeSimDate::AdvanceMonth()
+{
+	dayNumber = ((dayNumber / kDaysPerMonth) + 1) * kDaysPerMonth;
+}
+
+bool FakeSimDate::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeSimDate::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeSimDate::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool FakeSimDate::Set(uint32_t dwDay, uint32_t dwYear)
+{
+	if (dwDay == 0 || dwDay > kDaysPerYear)
+	{
+		return false;
+	}
+
+	dayNumber = (dwYear * kDaysPerYear) + (dwDay - 1);
+	return true;
+}
+
+bool FakeSimDate::Set(uint32_t dwMonth, uint32_t dwDay, uint32_t dwYear)
+{
+	if (!DayWithinMonth(dwMonth, dwDay, dwYear))
+	{
+		return false;
+	}
+
+	dayNumber = Jday(dwMonth, dwDay, dwYear);
+	return true;
+}
+
+bool FakeSimDate::Set(cRZTime const& sTime)
+{
+	return false;
+}
+
+bool FakeSimDate::Set(uint32_t dwDay)
+{
+	dayNumber = dwDay;
+	return true;
+}
+
+bool FakeSimDate::Set(char const* pszMonthName, uint32_t dwDay, uint32_t dwYear)
+{
+	return false;
+}
+
+bool FakeSimDate::Copy(cIGZDate const& sCopyFrom)
+{
+	dayNumber = GetDayNumber(sCopyFrom);
+	return true;
+}
+
+bool FakeSimDate::Clone(cIGZDate** ppCopyTo)
+{
+	return false;
+}
+
+bool FakeSimDate::Between(cIGZDate const& sStart, cIGZDate const& sEnd)
+{
+	return dayNumber >= GetDayNumber(sStart) && dayNumber <= GetDayNumber(sEnd);
+}
+
+int32_t FakeSimDate::CompareTo(cIGZDate const& sOther)
+{
+	const uint32_t otherDayNumber = GetDayNumber(sOther);
+
+	if (dayNumber < otherDayNumber)
+	{
+		return -1;
+	}
+	else if (dayNumber > otherDayNumber)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+uint32_t FakeSimDate::WeekDay()
+{
+	return dayNumber % 7;
+}
+
+uint32_t FakeSimDate::Year()
+{
+	return dayNumber / kDaysPerYear;
+}
+
+uint32_t FakeSimDate::DayOfYear()
+{
+	return (dayNumber % kDaysPerYear) + 1;
+}
+
+uint32_t FakeSimDate::DayOfMonth()
+{
+	return (dayNumber % kDaysPerMonth) + 1;
+}
+
+uint32_t FakeSimDate::FirstDayOfMonth()
+{
+	return (dayNumber / kDaysPerMonth) * kDaysPerMonth;
+}
+
+uint32_t FakeSimDate::FirstDayOfMonth(uint32_t dwMonth)
+{
+	return Jday(dwMonth, 1, Year());
+}
+
+uint32_t FakeSimDate::Hash()
+{
+	return dayNumber;
+}
+
+bool FakeSimDate::IsValid()
+{
+	return true;
+}
+
+bool FakeSimDate::Leap()
+{
+	return false;
+}
+
+bool FakeSimDate::MaxDate(cIGZDate const& sOther, cIGZDate& sMaxOut)
+{
+	if (dayNumber >= GetDayNumber(sOther))
+	{
+		return sMaxOut.Copy(*this);
+	}
+
+	return sMaxOut.Copy(sOther);
+}
+
+bool FakeSimDate::MinDate(cIGZDate const& sOther, cIGZDate& sMinOut)
+{
+	if (dayNumber <= GetDayNumber(sOther))
+	{
+		return sMinOut.Copy(*this);
+	}
+
+	return sMinOut.Copy(sOther);
+}
+
+uint32_t FakeSimDate::Month()
+{
+	return ((dayNumber % kDaysPerYear) / kDaysPerMonth) + 1;
+}
+
+uint32_t FakeSimDate::Previous(uint32_t dwDayOfPriorWeek, cIGZDate& sOut)
+{
+	return 0;
+}
+
+uint32_t FakeSimDate::YearLastTwoDigits()
+{
+	return Year() % 100;
+}
+
+uint32_t FakeSimDate::DayNumber()
+{
+	return dayNumber;
+}
+
+bool FakeSimDate::operator<(cIGZDate const& sOther)
+{
+	return dayNumber < GetDayNumber(sOther);
+}
+
+bool FakeSimDate::operator<=(cIGZDate const& sOther)
+{
+	return dayNumber <= GetDayNumber(sOther);
+}
+
+bool FakeSimDate::operator>(cIGZDate const& sOther)
+{
+	return dayNumber > GetDayNumber(sOther);
+}
+
+bool FakeSimDate::operator>=(cIGZDate const& sOther)
+{
+	return dayNumber >= GetDayNumber(sOther);
+}
+
+bool FakeSimDate::operator==(cIGZDate const& sOther)
+{
+	return dayNumber == GetDayNumber(sOther);
+}
+
+bool FakeSimDate::operator!=(cIGZDate const& sOther)
+{
+	return dayNumber != GetDayNumber(sOther);
+}
+
+cIGZDate& FakeSimDate::operator-(cIGZDate const& sOther)
+{
+	dayNumber -= GetDayNumber(sOther);
+	return *this;
+}
+
+cIGZDate& FakeSimDate::operator+(cIGZDate const& sOther)
+{
+	dayNumber += GetDayNumber(sOther);
+	return *this;
+}
+
+cIGZDate& FakeSimDate::operator-(int32_t nDays)
+{
+	dayNumber -= nDays;
+	return *this;
+}
+
+cIGZDate& FakeSimDate::operator+(int32_t nDays)
+{
+	dayNumber += nDays;
+	return *this;
+}
+
+cIGZDate& FakeSimDate::operator++()
+{
+	++dayNumber;
+	return *this;
+}
+
+cIGZDate& FakeSimDate::operator--()
+{
+	--dayNumber;
+	return *this;
+}
+
+cIGZDate& FakeSimDate::operator+=(int32_t nDays)
+{
+	dayNumber += nDays;
+	return *this;
+}
+
+cIGZDate& FakeSimDate::operator-=(int32_t nDays)
+{
+	dayNumber -= nDays;
+	return *this;
+}
+
+bool FakeSimDate::DateString(cIGZString& sDateOut, uint32_t dwFormatID)
+{
+	return false;
+}
+
+bool FakeSimDate::DayWithinMonth(uint32_t dwMonth, uint32_t dwDay, uint32_t dwYear)
+{
+	return dwMonth >= 1 && dwMonth <= kMonthsPerYear && dwDay >= 1 && dwDay <= kDaysPerMonth;
+}
+
+uint32_t FakeSimDate::DaysInYear(uint32_t dwYear)
+{
+	return kDaysPerYear;
+}
+
+uint32_t FakeSimDate::Jday(uint32_t dwMonth, uint32_t dwDay, uint32_t dwYear)
+{
+	return (dwYear * kDaysPerYear) + ((dwMonth - 1) * kDaysPerMonth) + (dwDay - 1);
+}
+
+bool FakeSimDate::LeapYear(uint32_t dwYear)
+{
+	return false;
+}
+
+uint32_t FakeSimDate::GetDayNumber(cIGZDate const& date)
+{
+	// The cIGZDate accessors are not const, but they do not modify the date.
+	return const_cast<cIGZDate&>(date).DayNumber();
+}
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZDate.h"
+
+// A stand-in for the game's cIGZDate implementation.
+// The date uses a simplified calendar where every month has 30 days, the harness
+// only needs a date that advances one month at a time and compares correctly.
+class FakeSimDate final : public cIGZDate
+{
+public:
+
+	FakeSimDate();
+
+	/**
+	 * @brief Advances the date to the first day of the next month.
+	*/
+	void AdvanceMonth();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Set(uint32_t dwDay, uint32_t dwYear) override;
+	bool Set(uint32_t dwMonth, uint32_t dwDay, uint32_t dwYear) override;
+	bool Set(cRZTime const& sTime) override;
+	bool Set(uint32_t dwDay) override;
+	bool Set(char const* pszMonthName, uint32_t dwDay, uint32_t dwYear) override;
+
+	bool Copy(cIGZDate const& sCopyFrom) override;
+	bool Clone(cIGZDate** ppCopyTo) override;
+
+	bool Between(cIGZDate const& sStart, cIGZDate const& sEnd) override;
+	int32_t CompareTo(cIGZDate const& sOther) override;
+
+	uint32_t WeekDay() override;
+	uint32_t Year() override;
+	uint32_t DayOfYear() override;
+	uint32_t DayOfMonth() override;
+	uint32_t FirstDayOfMonth() override;
+	uint32_t FirstDayOfMonth(uint32_t dwMonth) override;
+
+	uint32_t Hash() override;
+
+	bool IsValid() override;
+	bool Leap() override;
+	bool MaxDate(cIGZDate const& sOther, cIGZDate& sMaxOut) override;
+	bool MinDate(cIGZDate const& sOther, cIGZDate& sMinOut) override;
+
+	uint32_t Month() override;
+	uint32_t Previous(uint32_t dwDayOfPriorWeek, cIGZDate& sOut) override;
+	uint32_t YearLastTwoDigits() override;
+	uint32_t DayNumber() override;
+
+	bool operator<(cIGZDate const& sOther) override;
+	bool operator<=(cIGZDate const& sOther) override;
+	bool operator>(cIGZDate const& sOther) override;
+	bool operator>=(cIGZDate const& sOther) override;
+	bool operator==(cIGZDate const& sOther) override;
+	bool operator!=(cIGZDate const& sOther) override;
+
+	cIGZDate& operator-(cIGZDate const& sOther) override;
+	cIGZDate& operator+(cIGZDate const& sOther) override;
+
+	cIGZDate& operator-(int32_t nDays) override;
+	cIGZDate& operator+(int32_t nDays) override;
+
+	cIGZDate& operator++() override;
+	cIGZDate& operator--() override;
+
+	cIGZDate& operator+=(int32_t nDays) override;
+	cIGZDate& operator-=(int32_t nDays) override;
+
+	bool DateString(cIGZString& sDateOut, uint32_t dwFormatID) override;
+	bool DayWithinMonth(uint32_t dwMonth, uint32_t dwDay, uint32_t dwYear) override;
+
+	uint32_t DaysInYear(uint32_t dwYear) override;
+
+	uint32_t Jday(uint32_t dwMonth, uint32_t dwDay, uint32_t dwYear) override;
+	bool LeapYear(uint32_t dwYear) override;
+
+private:
+
+	static uint32_t GetDayNumber(cIGZDate const& date);
+
+	uint32_t dayNumber;
+	uint32_t refCount;
+};
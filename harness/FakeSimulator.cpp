@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "FakeSimulator.h"
+
+FakeSimulator::FakeSimulator()
+	: startDate(),
+	  simDate(),
+	  refCount(0)
+{
+}
+
+void FakeSimulator::AdvanceMonth()
+{
+	simDate.AdvanceMonth();
+}
+
+bool FakeSimulator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeSimulator::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeSimulator::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool FakeSimulator::Init()
+{
+	return true;
+}
+
+bool FakeSimulator::Shutdown()
+{
+	return true;
+}
+
+bool FakeSimulator::GetSimStartDate(cIGZDate& sDate)
+{
+	return sDate.Copy(startDate);
+}
+
+cIGZDate* FakeSimulator::GetSimDate()
+{
+	return &simDate;
+}
+
+void FakeSimulator::GetSimDate(long& year, long& month, long& day, long& dayOfYear, long& weekDay)
+{
+	year = static_cast<long>(simDate.Year());
+	month = static_cast<long>(simDate.Month());
+	day = static_cast<long>(simDate.DayOfMonth());
+	dayOfYear = static_cast<long>(simDate.DayOfYear());
+	weekDay = static_cast<long>(simDate.WeekDay());
+}
+
+int32_t FakeSimulator::GetSimDateNumber()
+{
+	return static_cast<int32_t>(simDate.DayNumber());
+}
+
+bool FakeSimulator::Pause()
+{
+	return false;
+}
+
+bool FakeSimulator::HiddenPause()
+{
+	return false;
+}
+
+bool FakeSimulator::EmergencyPause()
+{
+	return false;
+}
+
+bool FakeSimulator::Resume()
+{
+	return false;
+}
+
+bool FakeSimulator::HiddenResume()
+{
+	return false;
+}
+
+bool FakeSimulator::EmergencyResume()
+{
+	return false;
+}
+
+bool FakeSimulator::IsPaused()
+{
+	return false;
+}
+
+bool FakeSimulator::IsHiddenPaused()
+{
+	return false;
+}
+
+bool FakeSimulator::IsEmergencyPaused()
+{
+	return false;
+}
+
+bool FakeSimulator::IsAnyPaused()
+{
+	return false;
+}
+
+bool FakeSimulator::AddAgent(cIGZMessageTarget2* pAgent, uint32_t dwAgentType, cIGZString const& szAgentName, uint32_t dwUnknownFlags)
+{
+	return false;
+}
+
+bool FakeSimulator::RemoveAgent(cIGZMessageTarget2* pAgent, uint32_t dwAgentType)
+{
+	return false;
+}
+
+bool FakeSimulator::RemoveAgent(cIGZMessageTarget2* pAgent)
+{
+	return false;
+}
+
+bool FakeSimulator::RemoveAllAgents()
+{
+	return false;
+}
+
+bool FakeSimulator::RemoveAllAgents(uint32_t dwAgentType)
+{
+	return false;
+}
+
+bool FakeSimulator::EnumerateAgentsByName(std::vector<cIGZString>& sAgents)
+{
+	return false;
+}
+
+bool FakeSimulator::GetAgentEnabled(cIGZString const& szAgentName)
+{
+	return false;
+}
+
+bool FakeSimulator::SetAgentEnabled(cIGZString const& szAgentName, bool bEnabled)
+{
+	return false;
+}
+
+int32_t FakeSimulator::GetSimSpeed()
+{
+	return 0;
+}
+
+bool FakeSimulator::SetSimSpeed(int32_t lSpeed)
+{
+	return false;
+}
+
+int32_t FakeSimulator::GetSimTime()
+{
+	return 0;
+}
+
+bool FakeSimulator::SetSimTime(int32_t lTime)
+{
+	return false;
+}
+
+bool FakeSimulator::SetMaxMillisecondsPerTick(uint32_t dwTime)
+{
+	return false;
+}
+
+float FakeSimulator::GetAnimationTimeDilation()
+{
+	return 1.0f;
+}
+
+bool FakeSimulator::SetCityEstablished(bool bEstablished)
+{
+	return false;
+}
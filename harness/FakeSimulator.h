@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4Simulator.h"
+#include "FakeSimDate.h"
+
+// A stand-in for the game's cISC4Simulator that only tracks the simulation date.
+class FakeSimulator final : public cISC4Simulator
+{
+public:
+
+	FakeSimulator();
+
+	/**
+	 * @brief Advances the simulation date to the start of the next month.
+	*/
+	void AdvanceMonth();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init() override;
+	bool Shutdown() override;
+
+	bool GetSimStartDate(cIGZDate& sDate) override;
+
+	cIGZDate* GetSimDate() override;
+	void GetSimDate(long& year, long& month, long& day, long& dayOfYear, long& weekDay) override;
+	int32_t GetSimDateNumber() override;
+
+	bool Pause() override;
+	bool HiddenPause() override;
+	bool EmergencyPause() override;
+
+	bool Resume() override;
+	bool HiddenResume() override;
+	bool EmergencyResume() override;
+
+	bool IsPaused() override;
+	bool IsHiddenPaused() override;
+	bool IsEmergencyPaused() override;
+	bool IsAnyPaused() override;
+
+	bool AddAgent(cIGZMessageTarget2* pAgent, uint32_t dwAgentType, cIGZString const& szAgentName, uint32_t dwUnknownFlags) override;
+	bool RemoveAgent(cIGZMessageTarget2* pAgent, uint32_t dwAgentType) override;
+	bool RemoveAgent(cIGZMessageTarget2* pAgent) override;
+	bool RemoveAllAgents() override;
+	bool RemoveAllAgents(uint32_t dwAgentType) override;
+	bool EnumerateAgentsByName(std::vector<cIGZString>& sAgents) override;
+	bool GetAgentEnabled(cIGZString const& szAgentName) override;
+	bool SetAgentEnabled(cIGZString const& szAgentName, bool bEnabled) override;
+
+	int32_t GetSimSpeed() override;
+	bool SetSimSpeed(int32_t lSpeed) override;
+
+	int32_t GetSimTime() override;
+	bool SetSimTime(int32_t lTime) override;
+
+	bool SetMaxMillisecondsPerTick(uint32_t dwTime) override;
+
+	float GetAnimationTimeDilation() override;
+
+	bool SetCityEstablished(bool bEstablished) override;
+
+private:
+
+	FakeSimDate startDate;
+	FakeSimDate simDate;
+	uint32_t refCount;
+};
@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "cRZCOMDllDirector.h"
+
+static constexpr uint32_t kHarnessDirectorID = 0x5a1f0c3d;
+
+// The harness runs outside of the game, so the director is never started by the
+// framework. FrameWork() always returns null, and any code that asks for a game
+// service (e.g. the localized string lookup) will take its fallback path.
+class HarnessDllDirector final : public cRZCOMDllDirector
+{
+public:
+
+	uint32_t GetDirectorID() const
+	{
+		return kHarnessDirectorID;
+	}
+};
+
+cRZCOMDllDirector* RZGetCOMDllDirector()
+{
+	static HarnessDllDirector sDirector;
+	return &sDirector;
+}
@@ -0,0 +1,446 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryDBSegmentIStream.h"
+#include "cIGZString.h"
+#include "cIGZVariant.h"
+#include <cstring>
+
+MemoryDBSegmentIStream::MemoryDBSegmentIStream()
+	: data(nullptr),
+	  size(0),
+	  position(0),
+	  callCount(0),
+	  errorCallIndex(NoInjectedError),
+	  error(0),
+	  refCount(0),
+	  dbSegmentInterfaceAvailable(true)
+{
+}
+
+void MemoryDBSegmentIStream::Reset(const std::vector<uint8_t>& data)
+{
+	Reset(data.data(), data.size());
+}
+
+void MemoryDBSegmentIStream::Reset(const void* data, size_t size)
+{
+	this->data = static_cast<const uint8_t*>(data);
+	this->size = size;
+	position = 0;
+	callCount = 0;
+	error = 0;
+}
+
+void MemoryDBSegmentIStream::SetDBSegmentInterfaceAvailable(bool available)
+{
+	dbSegmentInterfaceAvailable = available;
+}
+
+void MemoryDBSegmentIStream::InjectErrorAtCall(uint64_t callIndex)
+{
+	errorCallIndex = callIndex;
+}
+
+uint64_t MemoryDBSegmentIStream::GetCallCount() const
+{
+	return callCount;
+}
+
+uint64_t MemoryDBSegmentIStream::GetByteCount() const
+{
+	return position;
+}
+
+uint32_t MemoryDBSegmentIStream::GetRefCount() const
+{
+	return refCount;
+}
+
+bool MemoryDBSegmentIStream::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4DBSegmentIStream && dbSegmentInterfaceAvailable)
+	{
+		AddRef();
+		*ppvObj = static_cast<cISC4DBSegmentIStream*>(this);
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t MemoryDBSegmentIStream::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t MemoryDBSegmentIStream::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool MemoryDBSegmentIStream::Skip(uint32_t dwBytes)
+{
+	return Consume(dwBytes) != nullptr;
+}
+
+bool MemoryDBSegmentIStream::GetSint8(int8_t& cValueOut)
+{
+	return GetVoid(&cValueOut, sizeof(cValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetUint8(uint8_t& ucValueOut)
+{
+	return GetVoid(&ucValueOut, sizeof(ucValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetSint16(int16_t& sValueOut)
+{
+	return GetVoid(&sValueOut, sizeof(sValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetUint16(uint16_t& usValueOut)
+{
+	return GetVoid(&usValueOut, sizeof(usValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetSint32(int32_t& lValueOut)
+{
+	return GetVoid(&lValueOut, sizeof(lValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetUint32(uint32_t& ulValueOut)
+{
+	return GetVoid(&ulValueOut, sizeof(ulValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetSint64(int64_t& llValueOut)
+{
+	return GetVoid(&llValueOut, sizeof(llValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetUint64(uint64_t& ullValueOut)
+{
+	return GetVoid(&ullValueOut, sizeof(ullValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetFloat32(float& fValueOut)
+{
+	return GetVoid(&fValueOut, sizeof(fValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetFloat64(double& dValueOut)
+{
+	return GetVoid(&dValueOut, sizeof(dValueOut));
+}
+
+bool MemoryDBSegmentIStream::GetRZCharStr(char* pszDataOut, uint32_t dwMaxBytes)
+{
+	uint32_t length = 0;
+
+	if (!GetUint32(length))
+	{
+		return false;
+	}
+
+	if (length >= dwMaxBytes)
+	{
+		error = 1;
+		return false;
+	}
+
+	if (!GetVoid(pszDataOut, length))
+	{
+		return false;
+	}
+
+	pszDataOut[length] = '\0';
+	return true;
+}
+
+bool MemoryDBSegmentIStream::GetGZStr(cIGZString& szDataOut)
+{
+	uint32_t length = 0;
+
+	if (!GetUint32(length))
+	{
+		return false;
+	}
+
+	const uint8_t* bytes = Consume(length);
+
+	if (!bytes)
+	{
+		return false;
+	}
+
+	szDataOut.FromChar(reinterpret_cast<const char*>(bytes), length);
+	return true;
+}
+
+bool MemoryDBSegmentIStream::GetGZSerializable(cIGZSerializable& sDataOut)
+{
+	return false;
+}
+
+bool MemoryDBSegmentIStream::GetVoid(void* pDataOut, uint32_t dwSize)
+{
+	const uint8_t* bytes = Consume(dwSize);
+
+	if (!bytes)
+	{
+		return false;
+	}
+
+	std::memcpy(pDataOut, bytes, dwSize);
+	return true;
+}
+
+int32_t MemoryDBSegmentIStream::GetError()
+{
+	return error;
+}
+
+int32_t MemoryDBSegmentIStream::SetUserData(cIGZVariant* pData)
+{
+	return 0;
+}
+
+int32_t MemoryDBSegmentIStream::GetUserData()
+{
+	return 0;
+}
+
+bool MemoryDBSegmentIStream::Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown)
+{
+	return true;
+}
+
+bool MemoryDBSegmentIStream::Close()
+{
+	return true;
+}
+
+bool MemoryDBSegmentIStream::IsOpen()
+{
+	return true;
+}
+
+int32_t MemoryDBSegmentIStream::GetRecord()
+{
+	return 0;
+}
+
+int32_t MemoryDBSegmentIStream::GetSegment()
+{
+	return 0;
+}
+
+bool MemoryDBSegmentIStream::ReadGZSerializable(cIGZSerializable** ppSegmentOut)
+{
+	return false;
+}
+
+bool MemoryDBSegmentIStream::ReadResKey(cGZPersistResourceKey& sKeyOut)
+{
+	return false;
+}
+
+bool MemoryDBSegmentIStream::ReadVariant(cIGZVariant& sVariantOut)
+{
+	uint16_t type = 0;
+
+	if (!GetUint16(type))
+	{
+		return false;
+	}
+
+	switch (type)
+	{
+	case cIGZVariant::Type::Empty:
+		return sVariantOut.Erase();
+	case cIGZVariant::Type::Bool:
+	{
+		uint8_t value = 0;
+		if (!GetUint8(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValBool(value != 0);
+		return true;
+	}
+	case cIGZVariant::Type::Uint8:
+	{
+		uint8_t value = 0;
+		if (!GetUint8(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValUint8(value);
+		return true;
+	}
+	case cIGZVariant::Type::Sint8:
+	{
+		int8_t value = 0;
+		if (!GetSint8(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValSint8(value);
+		return true;
+	}
+	case cIGZVariant::Type::Uint16:
+	{
+		uint16_t value = 0;
+		if (!GetUint16(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValUint16(value);
+		return true;
+	}
+	case cIGZVariant::Type::Sint16:
+	{
+		int16_t value = 0;
+		if (!GetSint16(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValSint16(value);
+		return true;
+	}
+	case cIGZVariant::Type::Uint32:
+	{
+		uint32_t value = 0;
+		if (!GetUint32(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValUint32(value);
+		return true;
+	}
+	case cIGZVariant::Type::Sint32:
+	{
+		int32_t value = 0;
+		if (!GetSint32(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValSint32(value);
+		return true;
+	}
+	case cIGZVariant::Type::Uint64:
+	{
+		uint64_t value = 0;
+		if (!GetUint64(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValUint64(value);
+		return true;
+	}
+	case cIGZVariant::Type::Sint64:
+	{
+		int64_t value = 0;
+		if (!GetSint64(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValSint64(value);
+		return true;
+	}
+	case cIGZVariant::Type::Float32:
+	{
+		float value = 0;
+		if (!GetFloat32(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValFloat32(value);
+		return true;
+	}
+	case cIGZVariant::Type::Float64:
+	{
+		double value = 0;
+		if (!GetFloat64(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValFloat64(value);
+		return true;
+	}
+	case cIGZVariant::Type::Char:
+	{
+		int8_t value = 0;
+		if (!GetSint8(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValChar(static_cast<char>(value));
+		return true;
+	}
+	case cIGZVariant::Type::RZUnicodeChar:
+	{
+		uint16_t value = 0;
+		if (!GetUint16(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValRZUnicodeChar(value);
+		return true;
+	}
+	case cIGZVariant::Type::RZChar:
+	{
+		int8_t value = 0;
+		if (!GetSint8(value))
+		{
+			return false;
+		}
+		sVariantOut.SetValRZChar(static_cast<char>(value));
+		return true;
+	}
+	default:
+		error = 1;
+		return false;
+	}
+}
+
+const uint8_t* MemoryDBSegmentIStream::Consume(uint32_t byteCount)
+{
+	const uint64_t callIndex = callCount++;
+
+	// Once a read has failed the stream stays in the error state, like a file
+	// stream after a read error.
+	if (error != 0 || callIndex == errorCallIndex || byteCount > (size - position))
+	{
+		error = 1;
+		return nullptr;
+	}
+
+	const uint8_t* bytes = data + position;
+	position += byteCount;
+
+	return bytes;
+}
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4DBSegmentIStream.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A stand-in for the game's DB segment input stream that reads from memory,
+// using the format written by MemoryDBSegmentOStream.
+//
+// The stream counts the calls and bytes that it reads, and can be made to
+// fail a read or to hide its cISC4DBSegmentIStream interface, so that the
+// error paths of the load code can be exercised.
+class MemoryDBSegmentIStream final : public cISC4DBSegmentIStream
+{
+public:
+
+	MemoryDBSegmentIStream();
+
+	/**
+	 * @brief Sets the data that the stream reads from and moves to the start of it.
+	 * @param data The data to read, the caller must keep it alive while the stream is used.
+	*/
+	void Reset(const std::vector<uint8_t>& data);
+
+	/**
+	 * @brief Sets the data that the stream reads from and moves to the start of it.
+	 * @param data The data to read, the caller must keep it alive while the stream is used.
+	 * @param size The size of the data in bytes.
+	*/
+	void Reset(const void* data, size_t size);
+
+	/**
+	 * @brief Makes the stream behave like a plain cIGZIStream.
+	 * @param available False if QueryInterface should refuse cISC4DBSegmentIStream.
+	*/
+	void SetDBSegmentInterfaceAvailable(bool available);
+
+	/**
+	 * @brief Makes a read fail and puts the stream into the error state.
+	 * The setting is kept when the stream is reset.
+	 * @param callIndex The zero-based index of the read that fails, counted
+	 * from the last Reset call. NoInjectedError disables the failure.
+	*/
+	void InjectErrorAtCall(uint64_t callIndex);
+
+	/**
+	 * @brief Gets the number of reads and skips since the last Reset call, including
+	 * the failed ones. Each value is one read, strings and variants are two.
+	 * @return The number of reads.
+	*/
+	uint64_t GetCallCount() const;
+
+	/**
+	 * @brief Gets the number of bytes read or skipped since the last Reset call.
+	 * @return The number of bytes read.
+	*/
+	uint64_t GetByteCount() const;
+
+	/**
+	 * @brief Gets the number of references that callers hold on the stream.
+	 * @return The reference count.
+	*/
+	uint32_t GetRefCount() const;
+
+	static constexpr uint64_t NoInjectedError = UINT64_MAX;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Skip(uint32_t dwBytes) override;
+
+	bool GetSint8(int8_t& cValueOut) override;
+	bool GetUint8(uint8_t& ucValueOut) override;
+	bool GetSint16(int16_t& sValueOut) override;
+	bool GetUint16(uint16_t& usValueOut) override;
+	bool GetSint32(int32_t& lValueOut) override;
+	bool GetUint32(uint32_t& ulValueOut) override;
+	bool GetSint64(int64_t& llValueOut) override;
+	bool GetUint64(uint64_t& ullValueOut) override;
+	bool GetFloat32(float& fValueOut) override;
+	bool GetFloat64(double& dValueOut) override;
+	bool GetRZCharStr(char* pszDataOut, uint32_t dwMaxBytes) override;
+	bool GetGZStr(cIGZString& szDataOut) override;
+	bool GetGZSerializable(cIGZSerializable& sDataOut) override;
+	bool GetVoid(void* pDataOut, uint32_t dwSize) override;
+
+	int32_t GetError() override;
+	int32_t SetUserData(cIGZVariant* pData) override;
+	int32_t GetUserData() override;
+
+	bool Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown) override;
+	bool Close() override;
+
+	bool IsOpen() override;
+
+	int32_t GetRecord() override;
+	int32_t GetSegment() override;
+
+	bool ReadGZSerializable(cIGZSerializable** ppSegmentOut) override;
+	bool ReadResKey(cGZPersistResourceKey& sKeyOut) override;
+	bool ReadVariant(cIGZVariant& sVariantOut) override;
+
+private:
+
+	const uint8_t* Consume(uint32_t byteCount);
+
+	const uint8_t* data;
+	size_t size;
+	size_t position;
+	uint64_t callCount;
+	uint64_t errorCallIndex;
+	int32_t error;
+	uint32_t refCount;
+	bool dbSegmentInterfaceAvailable;
+};
@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryDBSegmentOStream.h"
+#include "cIGZString.h"
+#include "cIGZVariant.h"
+#include <cstring>
+
+MemoryDBSegmentOStream::MemoryDBSegmentOStream()
+	: data(),
+	  callCount(0),
+	  errorCallIndex(NoInjectedError),
+	  errorByteLimit(NoInjectedError),
+	  error(0),
+	  refCount(0),
+	  dbSegmentInterfaceAvailable(true)
+{
+}
+
+const std::vector<uint8_t>& MemoryDBSegmentOStream::Data() const
+{
+	return data;
+}
+
+void MemoryDBSegmentOStream::Clear()
+{
+	data.clear();
+	callCount = 0;
+	error = 0;
+}
+
+void MemoryDBSegmentOStream::SetDBSegmentInterfaceAvailable(bool available)
+{
+	dbSegmentInterfaceAvailable = available;
+}
+
+void MemoryDBSegmentOStream::InjectErrorAtCall(uint64_t callIndex)
+{
+	errorCallIndex = callIndex;
+}
+
+void MemoryDBSegmentOStream::InjectErrorAtByteLimit(uint64_t byteLimit)
+{
+	errorByteLimit = byteLimit;
+}
+
+uint64_t MemoryDBSegmentOStream::GetCallCount() const
+{
+	return callCount;
+}
+
+uint64_t MemoryDBSegmentOStream::GetByteCount() const
+{
+	return data.size();
+}
+
+uint32_t MemoryDBSegmentOStream::GetRefCount() const
+{
+	return refCount;
+}
+
+bool MemoryDBSegmentOStream::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4DBSegmentOStream && dbSegmentInterfaceAvailable)
+	{
+		AddRef();
+		*ppvObj = static_cast<cISC4DBSegmentOStream*>(this);
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t MemoryDBSegmentOStream::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t MemoryDBSegmentOStream::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+void MemoryDBSegmentOStream::Flush()
+{
+}
+
+bool MemoryDBSegmentOStream::SetSint8(int8_t cValue)
+{
+	return SetVoid(&cValue, sizeof(cValue));
+}
+
+bool MemoryDBSegmentOStream::SetUint8(uint8_t ucValue)
+{
+	return SetVoid(&ucValue, sizeof(ucValue));
+}
+
+bool MemoryDBSegmentOStream::SetSint16(int16_t sValue)
+{
+	return SetVoid(&sValue, sizeof(sValue));
+}
+
+bool MemoryDBSegmentOStream::SetUint16(uint16_t usValue)
+{
+	return SetVoid(&usValue, sizeof(usValue));
+}
+
+bool MemoryDBSegmentOStream::SetSint32(int32_t lValue)
+{
+	return SetVoid(&lValue, sizeof(lValue));
+}
+
+bool MemoryDBSegmentOStream::SetUint32(uint32_t ulValue)
+{
+	return SetVoid(&ulValue, sizeof(ulValue));
+}
+
+bool MemoryDBSegmentOStream::SetSint64(int64_t llValue)
+{
+	return SetVoid(&llValue, sizeof(llValue));
+}
+
+bool MemoryDBSegmentOStream::SetUint64(uint64_t ullValue)
+{
+	return SetVoid(&ullValue, sizeof(ullValue));
+}
+
+bool MemoryDBSegmentOStream::SetFloat32(float fValue)
+{
+	return SetVoid(&fValue, sizeof(fValue));
+}
+
+bool MemoryDBSegmentOStream::SetFloat64(double dValue)
+{
+	return SetVoid(&dValue, sizeof(dValue));
+}
+
+bool MemoryDBSegmentOStream::SetRZCharStr(char const* pszData)
+{
+	const uint32_t length = static_cast<uint32_t>(std::strlen(pszData));
+
+	return SetUint32(length) && SetVoid(pszData, length);
+}
+
+bool MemoryDBSegmentOStream::SetGZStr(cIGZString const& szData)
+{
+	const uint32_t length = szData.Strlen();
+
+	return SetUint32(length) && SetVoid(szData.Data(), length);
+}
+
+bool MemoryDBSegmentOStream::SetGZSerializable(cIGZSerializable const& sData)
+{
+	return false;
+}
+
+bool MemoryDBSegmentOStream::SetVoid(void const* pData, uint32_t dwSize)
+{
+	const uint64_t callIndex = callCount++;
+
+	// Once a write has failed the stream stays in the error state, like a file
+	// stream after a write error.
+	if (error != 0 || callIndex == errorCallIndex || (data.size() + dwSize) > errorByteLimit)
+	{
+		error = 1;
+		return false;
+	}
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(pData);
+
+	data.insert(data.end(), bytes, bytes + dwSize);
+
+	return true;
+}
+
+int32_t MemoryDBSegmentOStream::GetError()
+{
+	return error;
+}
+
+int32_t MemoryDBSegmentOStream::SetUserData(cIGZVariant* pData)
+{
+	return 0;
+}
+
+int32_t MemoryDBSegmentOStream::GetUserData()
+{
+	return 0;
+}
+
+bool MemoryDBSegmentOStream::Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown)
+{
+	return true;
+}
+
+bool MemoryDBSegmentOStream::Close()
+{
+	return true;
+}
+
+bool MemoryDBSegmentOStream::IsOpen()
+{
+	return true;
+}
+
+int32_t MemoryDBSegmentOStream::GetRecord()
+{
+	return 0;
+}
+
+int32_t MemoryDBSegmentOStream::GetSegment()
+{
+	return 0;
+}
+
+bool MemoryDBSegmentOStream::WriteGZSerializable(cIGZSerializable const* pSegment)
+{
+	return false;
+}
+
+bool MemoryDBSegmentOStream::WriteResKey(cGZPersistResourceKey const& sKey)
+{
+	return false;
+}
+
+bool MemoryDBSegmentOStream::WriteVariant(cIGZVariant const& sVariant)
+{
+	const uint16_t type = sVariant.GetType();
+
+	if (!SetUint16(type))
+	{
+		return false;
+	}
+
+	switch (type)
+	{
+	case cIGZVariant::Type::Empty:
+		return true;
+	case cIGZVariant::Type::Bool:
+		return SetUint8(sVariant.GetValBool() ? 1 : 0);
+	case cIGZVariant::Type::Uint8:
+		return SetUint8(sVariant.GetValUint8());
+	case cIGZVariant::Type::Sint8:
+		return SetSint8(sVariant.GetValSint8());
+	case cIGZVariant::Type::Uint16:
+		return SetUint16(sVariant.GetValUint16());
+	case cIGZVariant::Type::Sint16:
+		return SetSint16(sVariant.GetValSint16());
+	case cIGZVariant::Type::Uint32:
+		return SetUint32(sVariant.GetValUint32());
+	case cIGZVariant::Type::Sint32:
+		return SetSint32(sVariant.GetValSint32());
+	case cIGZVariant::Type::Uint64:
+		return SetUint64(sVariant.GetValUint64());
+	case cIGZVariant::Type::Sint64:
+		return SetSint64(sVariant.GetValSint64());
+	case cIGZVariant::Type::Float32:
+		return SetFloat32(sVariant.GetValFloat32());
+	case cIGZVariant::Type::Float64:
+		return SetFloat64(sVariant.GetValFloat64());
+	case cIGZVariant::Type::Char:
+		return SetSint8(static_cast<int8_t>(sVariant.GetValChar()));
+	case cIGZVariant::Type::RZUnicodeChar:
+		return SetUint16(sVariant.GetValRZUnicodeChar());
+	case cIGZVariant::Type::RZChar:
+		return SetSint8(static_cast<int8_t>(sVariant.GetValRZChar()));
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZVariant.h"
+#include "cISC4DBSegmentOStream.h"
+#include <cstdint>
+#include <vector>
+
+// A stand-in for the game's DB segment output stream that writes to memory.
+// Values are stored in the native byte order, strings are prefixed with
+// their length and variants are stored as a type code followed by the value.
+// Only scalar variant types are supported, the ordinance code does not use
+// array properties.
+//
+// The stream counts the calls and bytes that it is given, and can be made to
+// fail a write or to hide its cISC4DBSegmentOStream interface, so that the
+// error paths of the save code can be exercised.
+class MemoryDBSegmentOStream final : public cISC4DBSegmentOStream
+{
+public:
+
+	MemoryDBSegmentOStream();
+
+	/**
+	 * @brief Gets the data that has been written to the stream.
+	 * @return The data that has been written to the stream.
+	*/
+	const std::vector<uint8_t>& Data() const;
+
+	/**
+	 * @brief Discards the data that has been written to the stream.
+	 * The buffer capacity is kept so that it can be reused.
+	*/
+	void Clear();
+
+	/**
+	 * @brief Makes the stream behave like a plain cIGZOStream.
+	 * @param available False if QueryInterface should refuse cISC4DBSegmentOStream.
+	*/
+	void SetDBSegmentInterfaceAvailable(bool available);
+
+	/**
+	 * @brief Makes a write fail and puts the stream into the error state.
+	 * The setting is kept when the stream is cleared.
+	 * @param callIndex The zero-based index of the write that fails, counted
+	 * from the last Clear call. NoInjectedError disables the failure.
+	*/
+	void InjectErrorAtCall(uint64_t callIndex);
+
+	/**
+	 * @brief Makes the stream fail the write that would take it past a size limit,
+	 * like a full disk. The setting is kept when the stream is cleared.
+	 * @param byteLimit The maximum number of bytes that can be written. NoInjectedError
+	 * disables the limit.
+	*/
+	void InjectErrorAtByteLimit(uint64_t byteLimit);
+
+	/**
+	 * @brief Gets the number of writes since the last Clear call, including the failed writes.
+	 * Each value is one write, strings and variants are two.
+	 * @return The number of writes.
+	*/
+	uint64_t GetCallCount() const;
+
+	/**
+	 * @brief Gets the number of bytes written since the last Clear call.
+	 * @return The number of bytes written.
+	*/
+	uint64_t GetByteCount() const;
+
+	/**
+	 * @brief Gets the number of references that callers hold on the stream.
+	 * @return The reference count.
+	*/
+	uint32_t GetRefCount() const;
+
+	static constexpr uint64_t NoInjectedError = UINT64_MAX;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	void Flush() override;
+
+	bool SetSint8(int8_t cValue) override;
+	bool SetUint8(uint8_t ucValue) override;
+	bool SetSint16(int16_t sValue) override;
+	bool SetUint16(uint16_t usValue) override;
+	bool SetSint32(int32_t lValue) override;
+	bool SetUint32(uint32_t ulValue) override;
+	bool SetSint64(int64_t llValue) override;
+	bool SetUint64(uint64_t ullValue) override;
+	bool SetFloat32(float fValue) override;
+	bool SetFloat64(double dValue) override;
+	bool SetRZCharStr(char const* pszData) override;
+	bool SetGZStr(cIGZString const& szData) override;
+	bool SetGZSerializable(cIGZSerializable const& sData) override;
+	bool SetVoid(void const* pData, uint32_t dwSize) override;
+
+	int32_t GetError() override;
+	int32_t SetUserData(cIGZVariant* pData) override;
+	int32_t GetUserData() override;
+
+	bool Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown) override;
+	bool Close() override;
+
+	bool IsOpen() override;
+
+	int32_t GetRecord() override;
+	int32_t GetSegment() override;
+
+	bool WriteGZSerializable(cIGZSerializable const* pSegment) override;
+	bool WriteResKey(cGZPersistResourceKey const& sKey) override;
+	bool WriteVariant(cIGZVariant const& sVariant) override;
+
+private:
+
+	std::vector<uint8_t> data;
+	uint64_t callCount;
+	uint64_t errorCallIndex;
+	uint64_t errorByteLimit;
+	int32_t error;
+	uint32_t refCount;
+	bool dbSegmentInterfaceAvailable;
+};
@@ -0,0 +1,552 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "SaveFuzzer.h"
+#include "CityLotteryOrdinance.h"
+#include "cIGZSerializable.h"
+#include "cRZBaseVariant.h"
+#include "cSCBaseProperty.h"
+#include "ISettings.h"
+#include "OrdinanceBase.h"
+#include "OrdinancePropertyHolder.h"
+#include "SaveRecordCodec.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	constexpr uint32_t MaxPropertyCount = 40;
+	constexpr uint32_t MaxCorruptedByteCount = 4;
+	constexpr uint64_t MaxPrintedFailureCount = 20;
+	constexpr uint32_t MaxUnknownSectionSize = 32;
+
+	class FuzzSettings final : public ISettings
+	{
+	public:
+
+		int64_t MonthlyConstantIncome() const override
+		{
+			return monthlyConstantIncome;
+		}
+
+		const std::vector<PopulationIncomeFactor>& PopulationIncomeFactors() const override
+		{
+			return populationIncomeFactors;
+		}
+
+		OrdinancePropertyHolder OrdinanceEffects() const override
+		{
+			return ordinanceEffects;
+		}
+
+		int64_t monthlyConstantIncome = 0;
+		std::vector<PopulationIncomeFactor> populationIncomeFactors;
+		// Settings::OrdinanceEffects replaces the duplicate properties, like the loaded ordinance.
+		OrdinancePropertyHolder ordinanceEffects{ OrdinancePropertyHolder::DuplicatePropertyMode::Replace };
+	};
+
+	// Returns values of every magnitude, so that all of the varint lengths are used.
+	int64_t RandomInt64(std::mt19937_64& random)
+	{
+		const int64_t value = static_cast<int64_t>(random() >> (random() % 64));
+
+		return (random() & 1) ? -value : value;
+	}
+
+	float RandomFloat(std::mt19937_64& random)
+	{
+		return std::uniform_real_distribution<float>(-1.0e6f, 1.0e6f)(random);
+	}
+
+	uint32_t RandomPropertyID(std::mt19937_64& random)
+	{
+		// Half of the IDs are from a small range, so that some holders have duplicates.
+		return (random() & 1) ? static_cast<uint32_t>(random()) : 0x1000 + static_cast<uint32_t>(random() % 64);
+	}
+
+	void SetRandomValue(cRZBaseVariant& variant, std::mt19937_64& random)
+	{
+		const uint64_t bits = random();
+
+		switch (random() % 15)
+		{
+		case 0:
+			variant.SetValBool((bits & 1) != 0);
+			break;
+		case 1:
+			variant.SetValUint8(static_cast<uint8_t>(bits));
+			break;
+		case 2:
+			variant.SetValSint8(static_cast<int8_t>(bits));
+			break;
+		case 3:
+			variant.SetValUint16(static_cast<uint16_t>(bits));
+			break;
+		case 4:
+			variant.SetValSint16(static_cast<int16_t>(bits));
+			break;
+		case 5:
+			variant.SetValUint32(static_cast<uint32_t>(bits));
+			break;
+		case 6:
+			variant.SetValSint32(static_cast<int32_t>(bits));
+			break;
+		case 7:
+			variant.SetValUint64(bits);
+			break;
+		case 8:
+			variant.SetValSint64(RandomInt64(random));
+			break;
+		case 9:
+			variant.SetValFloat32(RandomFloat(random));
+			break;
+		case 10:
+			variant.SetValFloat64(static_cast<double>(RandomFloat(random)) / 3.0);
+			break;
+		case 11:
+			variant.SetValChar(static_cast<char>(bits));
+			break;
+		case 12:
+			variant.SetValRZUnicodeChar(static_cast<uint16_t>(bits));
+			break;
+		case 13:
+			variant.SetValRZChar(static_cast<char>(bits));
+			break;
+		default:
+			// An empty variant.
+			break;
+		}
+	}
+
+	cSCBaseProperty CreateRandomProperty(std::mt19937_64& random)
+	{
+		cRZBaseVariant value;
+		SetRandomValue(value, random);
+
+		return cSCBaseProperty(RandomPropertyID(random), value);
+	}
+
+	// Returns the number of properties that were added.
+	uint32_t AddRandomProperties(OrdinancePropertyHolder& holder, std::mt19937_64& random)
+	{
+		const uint32_t count = static_cast<uint32_t>(random() % (MaxPropertyCount + 1));
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			cRZBaseVariant value;
+			SetRandomValue(value, random);
+
+			holder.AddProperty(RandomPropertyID(random), &value, false);
+		}
+
+		return count;
+	}
+
+	void SetRandomState(OrdinanceBase& ordinance, std::mt19937_64& random)
+	{
+		ordinance.SetAvailable((random() & 1) != 0);
+		ordinance.SetOn((random() & 1) != 0);
+		ordinance.SetEnabled((random() & 1) != 0);
+	}
+
+	bool WriteSerializable(cISC4Ordinance& ordinance, cIGZOStream& stream)
+	{
+		cIGZSerializable* serializable = nullptr;
+
+		if (!ordinance.QueryInterface(GZIID_cIGZSerializable, reinterpret_cast<void**>(&serializable)))
+		{
+			return false;
+		}
+
+		const bool result = serializable->Write(stream);
+		serializable->Release();
+
+		return result;
+	}
+
+	bool ReadSerializable(cISC4Ordinance& ordinance, cIGZIStream& stream)
+	{
+		cIGZSerializable* serializable = nullptr;
+
+		if (!ordinance.QueryInterface(GZIID_cIGZSerializable, reinterpret_cast<void**>(&serializable)))
+		{
+			return false;
+		}
+
+		const bool result = serializable->Read(stream);
+		serializable->Release();
+
+		return result;
+	}
+}
+
+SaveFuzzer::SaveFuzzer(uint64_t seed)
+	: random(seed),
+	  output(),
+	  input(),
+	  saved(),
+	  corrupted(),
+	  newerVersion(),
+	  iteration(0)
+{
+}
+
+bool SaveFuzzer::Run(uint64_t iterations)
+{
+	SaveStatistics propertyStatistics{ "cSCBaseProperty" };
+	SaveStatistics holderStatistics{ "OrdinancePropertyHolder" };
+	SaveStatistics ordinanceBaseStatistics{ "OrdinanceBase" };
+	SaveStatistics lotteryStatistics{ "CityLotteryOrdinance" };
+
+	cSCBaseProperty loadedProperty;
+	OrdinancePropertyHolder loadedHolder;
+	OrdinanceBase loadedOrdinanceBase(0, "", "", 0, 0, 0, 0.0f, false);
+	CityLotteryOrdinance loadedLottery;
+
+	for (iteration = 0; iteration < iterations; iteration++)
+	{
+		const cSCBaseProperty property = CreateRandomProperty(random);
+
+		CheckSave(
+			propertyStatistics,
+			true,
+			[&](cIGZOStream& stream) { return property.Write(stream); },
+			[&](cIGZIStream& stream) { return loadedProperty.Read(stream); },
+			[&](cIGZOStream& stream) { return loadedProperty.Write(stream); });
+
+		OrdinancePropertyHolder holder;
+		const uint32_t propertyCount = AddRandomProperties(holder, random);
+
+		// An empty holder is only a property count, which does not need the DB segment interface.
+		CheckSave(
+			holderStatistics,
+			propertyCount > 0,
+			[&](cIGZOStream& stream) { return holder.Write(stream); },
+			[&](cIGZIStream& stream) { return loadedHolder.Read(stream); },
+			[&](cIGZOStream& stream) { return loadedHolder.Write(stream); });
+
+		OrdinancePropertyHolder ordinanceEffects;
+		AddRandomProperties(ordinanceEffects, random);
+
+		OrdinanceBase ordinanceBase(
+			static_cast<uint32_t>(random()),
+			"Fuzz",
+			"Fuzz",
+			RandomInt64(random),
+			RandomInt64(random),
+			RandomInt64(random),
+			RandomFloat(random),
+			(random() & 1) != 0,
+			ordinanceEffects);
+		SetRandomState(ordinanceBase, random);
+
+		const auto readOrdinanceBase = [&](cIGZIStream& stream) { return ReadSerializable(loadedOrdinanceBase, stream); };
+		const auto writeLoadedOrdinanceBase = [&](cIGZOStream& stream) { return WriteSerializable(loadedOrdinanceBase, stream); };
+
+		if (CheckSave(
+			ordinanceBaseStatistics,
+			false,
+			[&](cIGZOStream& stream) { return WriteSerializable(ordinanceBase, stream); },
+			readOrdinanceBase,
+			writeLoadedOrdinanceBase))
+		{
+			CheckNewerVersion(ordinanceBaseStatistics, readOrdinanceBase, writeLoadedOrdinanceBase);
+		}
+
+		// The settings only contain the census groups with a positive factor.
+		std::uniform_real_distribution<float> incomeFactorDistribution(0.001f, 10.0f);
+
+		FuzzSettings settings;
+		settings.monthlyConstantIncome = RandomInt64(random);
+		settings.populationIncomeFactors =
+		{
+			{ CensusGroupID::ResidentialLowWealth, incomeFactorDistribution(random) },
+			{ CensusGroupID::ResidentialMedWealth, incomeFactorDistribution(random) },
+			{ CensusGroupID::ResidentialHighWealth, incomeFactorDistribution(random) },
+		};
+		AddRandomProperties(settings.ordinanceEffects, random);
+
+		CityLotteryOrdinance lottery;
+		lottery.UpdateOrdinanceData(settings);
+		SetRandomState(lottery, random);
+
+		const auto readLottery = [&](cIGZIStream& stream) { return loadedLottery.Read(stream); };
+		const auto writeLoadedLottery = [&](cIGZOStream& stream) { return loadedLottery.Write(stream); };
+
+		if (CheckSave(
+			lotteryStatistics,
+			false,
+			[&](cIGZOStream& stream) { return lottery.Write(stream); },
+			readLottery,
+			writeLoadedLottery))
+		{
+			CheckNewerVersion(lotteryStatistics, readLottery, writeLoadedLottery);
+		}
+	}
+
+	bool passed = true;
+
+	for (const SaveStatistics* statistics : { &propertyStatistics, &holderStatistics, &ordinanceBaseStatistics, &lotteryStatistics })
+	{
+		const double bytesPerSave = statistics->saves > 0
+			? static_cast<double>(statistics->savedBytes) / static_cast<double>(statistics->saves)
+			: 0.0;
+		const double callsPerSave = statistics->saves > 0
+			? static_cast<double>(statistics->streamCalls) / static_cast<double>(statistics->saves)
+			: 0.0;
+
+		std::printf(
+			"%-24s saves: %llu, bytes per save: %.1f, writes per save: %.1f, corrupted saves loaded: %llu/%llu, failed checks: %llu\n",
+			statistics->name,
+			static_cast<unsigned long long>(statistics->saves),
+			bytesPerSave,
+			callsPerSave,
+			static_cast<unsigned long long>(statistics->corruptedSavesLoaded),
+			static_cast<unsigned long long>(statistics->corruptedSaves),
+			static_cast<unsigned long long>(statistics->failedChecks));
+
+		if (statistics->failedChecks > 0)
+		{
+			passed = false;
+		}
+	}
+
+	return passed;
+}
+
+bool SaveFuzzer::CheckSave(
+	SaveStatistics& statistics,
+	bool requiresDBSegmentInterface,
+	const std::function<bool(cIGZOStream&)>& writeSaved,
+	const std::function<bool(cIGZIStream&)>& read,
+	const std::function<bool(cIGZOStream&)>& writeLoaded)
+{
+	// The error injection settings are kept when the streams are cleared or reset.
+	output.InjectErrorAtCall(MemoryDBSegmentOStream::NoInjectedError);
+	output.InjectErrorAtByteLimit(MemoryDBSegmentOStream::NoInjectedError);
+	output.SetDBSegmentInterfaceAvailable(true);
+	input.InjectErrorAtCall(MemoryDBSegmentIStream::NoInjectedError);
+	input.SetDBSegmentInterfaceAvailable(true);
+
+	output.Clear();
+
+	if (!writeSaved(output) || output.GetError() != 0)
+	{
+		ReportFailure(statistics, "write");
+		return false;
+	}
+
+	saved = output.Data();
+
+	const uint64_t writeCallCount = output.GetCallCount();
+
+	statistics.saves++;
+	statistics.savedBytes += output.GetByteCount();
+	statistics.streamCalls += writeCallCount;
+
+	// The saved object is loaded, and saving the loaded object produces the same data.
+
+	input.Reset(saved);
+
+	if (!read(input) || input.GetError() != 0 || input.GetByteCount() != saved.size())
+	{
+		ReportFailure(statistics, "read");
+		return false;
+	}
+
+	const uint64_t readCallCount = input.GetCallCount();
+
+	output.Clear();
+
+	if (!writeLoaded(output) || output.Data() != saved)
+	{
+		ReportFailure(statistics, "write of the loaded object");
+	}
+
+	// A write or read error fails the save or load.
+
+	output.Clear();
+	output.InjectErrorAtCall(random() % writeCallCount);
+
+	if (writeSaved(output) || output.GetError() == 0)
+	{
+		ReportFailure(statistics, "write with an error");
+	}
+
+	output.InjectErrorAtCall(MemoryDBSegmentOStream::NoInjectedError);
+	output.InjectErrorAtByteLimit(random() % saved.size());
+	output.Clear();
+
+	if (writeSaved(output) || output.GetByteCount() >= saved.size())
+	{
+		ReportFailure(statistics, "write past the byte limit");
+	}
+
+	output.InjectErrorAtByteLimit(MemoryDBSegmentOStream::NoInjectedError);
+
+	input.InjectErrorAtCall(random() % readCallCount);
+	input.Reset(saved);
+
+	if (read(input) || input.GetError() == 0)
+	{
+		ReportFailure(statistics, "read with an error");
+	}
+
+	input.InjectErrorAtCall(MemoryDBSegmentIStream::NoInjectedError);
+
+	// A truncated save fails to load.
+
+	input.Reset(saved.data(), random() % saved.size());
+
+	if (read(input))
+	{
+		ReportFailure(statistics, "read of a truncated save");
+	}
+
+	// A save with corrupted bytes can be loaded or rejected, but if it is loaded
+	// the object can be saved again.
+
+	corrupted = saved;
+
+	const uint32_t corruptedByteCount = 1 + static_cast<uint32_t>(random() % MaxCorruptedByteCount);
+
+	for (uint32_t i = 0; i < corruptedByteCount; i++)
+	{
+		corrupted[random() % corrupted.size()] ^= static_cast<uint8_t>(1 + random() % 255);
+	}
+
+	statistics.corruptedSaves++;
+	input.Reset(corrupted);
+
+	if (read(input))
+	{
+		statistics.corruptedSavesLoaded++;
+
+		output.Clear();
+
+		if (!writeLoaded(output))
+		{
+			ReportFailure(statistics, "write of a loaded corrupted save");
+		}
+	}
+
+	// Without the DB segment interface the streams behave like the plain
+	// cIGZOStream and cIGZIStream.
+
+	output.SetDBSegmentInterfaceAvailable(false);
+	input.SetDBSegmentInterfaceAvailable(false);
+	output.Clear();
+
+	const bool plainWriteResult = writeSaved(output);
+
+	input.Reset(saved);
+
+	const bool plainReadResult = read(input);
+
+	if (requiresDBSegmentInterface)
+	{
+		if (plainWriteResult || plainReadResult)
+		{
+			ReportFailure(statistics, "save without the DB segment interface");
+		}
+	}
+	else if (!plainWriteResult || output.Data() != saved || !plainReadResult)
+	{
+		ReportFailure(statistics, "save without the DB segment interface");
+	}
+
+	if (!StreamsReleased())
+	{
+		ReportFailure(statistics, "stream reference count");
+	}
+
+	return true;
+}
+
+void SaveFuzzer::CheckNewerVersion(
+	SaveStatistics& statistics,
+	const std::function<bool(cIGZIStream&)>& read,
+	const std::function<bool(cIGZOStream&)>& writeLoaded)
+{
+	constexpr size_t SectionHeaderSize = sizeof(uint16_t) + sizeof(uint32_t);
+
+	uint32_t version = 0;
+	std::memcpy(&version, saved.data(), sizeof(version));
+	version += 1 + static_cast<uint32_t>(random() % 16);
+
+	// The tags from 0x8000 up are not used by this build.
+	const uint16_t unknownTag = static_cast<uint16_t>(0x8000 | (random() & 0x7fff));
+	const uint32_t unknownSectionSize = static_cast<uint32_t>(random() % (MaxUnknownSectionSize + 1));
+	const uint32_t payloadSize = static_cast<uint32_t>(saved.size() - SaveRecordWriter::HeaderSize + SectionHeaderSize + unknownSectionSize);
+
+	newerVersion.resize(SaveRecordWriter::HeaderSize);
+	std::memcpy(newerVersion.data(), &version, sizeof(version));
+	std::memcpy(newerVersion.data() + sizeof(version), &payloadSize, sizeof(payloadSize));
+
+	// The unknown section is placed before or after the known sections.
+	const bool unknownSectionFirst = (random() & 1) != 0;
+
+	if (!unknownSectionFirst)
+	{
+		newerVersion.insert(newerVersion.end(), saved.begin() + SaveRecordWriter::HeaderSize, saved.end());
+	}
+
+	const uint8_t* tagBytes = reinterpret_cast<const uint8_t*>(&unknownTag);
+	const uint8_t* sizeBytes = reinterpret_cast<const uint8_t*>(&unknownSectionSize);
+
+	newerVersion.insert(newerVersion.end(), tagBytes, tagBytes + sizeof(unknownTag));
+	newerVersion.insert(newerVersion.end(), sizeBytes, sizeBytes + sizeof(unknownSectionSize));
+
+	for (uint32_t i = 0; i < unknownSectionSize; i++)
+	{
+		newerVersion.push_back(static_cast<uint8_t>(random()));
+	}
+
+	if (unknownSectionFirst)
+	{
+		newerVersion.insert(newerVersion.end(), saved.begin() + SaveRecordWriter::HeaderSize, saved.end());
+	}
+
+	input.Reset(newerVersion);
+
+	if (!read(input))
+	{
+		ReportFailure(statistics, "read of a newer version");
+		return;
+	}
+
+	output.Clear();
+
+	if (!writeLoaded(output) || output.Data() != saved)
+	{
+		ReportFailure(statistics, "write of a loaded newer version");
+	}
+}
+
+void SaveFuzzer::ReportFailure(SaveStatistics& statistics, const char* check)
+{
+	if (statistics.failedChecks < MaxPrintedFailureCount)
+	{
+		std::printf(
+			"%s: the %s check failed at iteration %llu.\n",
+			statistics.name,
+			check,
+			static_cast<unsigned long long>(iteration));
+	}
+
+	statistics.failedChecks++;
+}
+
+bool SaveFuzzer::StreamsReleased() const
+{
+	return output.GetRefCount() == 0 && input.GetRefCount() == 0;
+}
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MemoryDBSegmentIStream.h"
+#include "MemoryDBSegmentOStream.h"
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+class cIGZIStream;
+class cIGZOStream;
+
+// Saves random properties, property holders and ordinances to the memory streams
+// and loads them back, then repeats the save and load with injected stream errors,
+// truncated data and corrupted bytes. Build it with SC4_ENABLE_SANITIZERS to also
+// catch the memory errors on the failure paths.
+class SaveFuzzer
+{
+public:
+
+	/**
+	 * @brief Constructs an instance of the class.
+	 * @param seed The seed of the random number generator, a run can be repeated with the same seed.
+	*/
+	explicit SaveFuzzer(uint64_t seed);
+
+	/**
+	 * @brief Runs the fuzzer and prints a summary of each save type.
+	 * @param iterations The number of random objects of each type.
+	 * @return True if all of the checks passed; otherwise, false.
+	*/
+	bool Run(uint64_t iterations);
+
+private:
+
+	struct SaveStatistics
+	{
+		const char* name = nullptr;
+		uint64_t saves = 0;
+		uint64_t savedBytes = 0;
+		uint64_t streamCalls = 0;
+		uint64_t corruptedSaves = 0;
+		uint64_t corruptedSavesLoaded = 0;
+		uint64_t failedChecks = 0;
+	};
+
+	/**
+	 * @brief Checks the save and load of one object.
+	 * @param statistics The statistics of the save type.
+	 * @param requiresDBSegmentInterface True if the save fails on a plain cIGZOStream/cIGZIStream.
+	 * @param writeSaved Writes the random object.
+	 * @param read Reads into the loaded object.
+	 * @param writeLoaded Writes the loaded object.
+	 * @return True if the object was saved and loaded; otherwise, false.
+	*/
+	bool CheckSave(
+		SaveStatistics& statistics,
+		bool requiresDBSegmentInterface,
+		const std::function<bool(cIGZOStream&)>& writeSaved,
+		const std::function<bool(cIGZIStream&)>& read,
+		const std::function<bool(cIGZOStream&)>& writeLoaded);
+
+	/**
+	 * @brief Checks that a tagged save record from a newer version, with a section
+	 * that this build does not know, loads the same object as the last save.
+	 * @param statistics The statistics of the save type.
+	 * @param read Reads into the loaded object.
+	 * @param writeLoaded Writes the loaded object.
+	*/
+	void CheckNewerVersion(
+		SaveStatistics& statistics,
+		const std::function<bool(cIGZIStream&)>& read,
+		const std::function<bool(cIGZOStream&)>& writeLoaded);
+
+	void ReportFailure(SaveStatistics& statistics, const char* check);
+	bool StreamsReleased() const;
+
+	std::mt19937_64 random;
+	MemoryDBSegmentOStream output;
+	MemoryDBSegmentIStream input;
+	std::vector<uint8_t> saved;
+	std::vector<uint8_t> corrupted;
+	std::vector<uint8_t> newerVersion;
+	uint64_t iteration;
+};
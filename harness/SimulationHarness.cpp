@@ -0,0 +1,463 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// A headless driver that runs the city lottery ordinance against stand-in
+// SC4 simulators, so the cost of the monthly callbacks can be measured
+// without starting the game.
+
+#include "CityLotteryOrdinance.h"
+#include "CityScenario.h"
+#include "EntryPointStatistics.h"
+#include "IncomeKernel.h"
+#include "Logger.h"
+#include "SaveFuzzer.h"
+#include "Settings.h"
+#include "TraceEventRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <exception>
+#include <filesystem>
+#include <random>
+
+namespace
+{
+	struct HarnessOptions
+	{
+		uint64_t months = 1000000;
+		uint32_t budgetPollCount = 4;
+		uint32_t cityReloadInterval = 0;
+		uint64_t incomeKernelCheckCount = 0;
+		uint64_t saveFuzzIterations = 0;
+		bool checkSharedEffects = false;
+		std::filesystem::path settingsPath;
+		std::filesystem::path logPath;
+		std::filesystem::path tracePath;
+		LogWriteMode logWriteMode = LogWriteMode::Asynchronous;
+		size_t logMaxFileSize = 0;
+		bool logDeduplication = false;
+		uint32_t logMonthlyLineLimit = 0;
+		bool printEntryPointStatistics = false;
+		bool recordEntryPointLatency = false;
+	};
+
+	void PrintUsage(const char* programName)
+	{
+		std::printf(
+			"Usage: %s [options]\n"
+			"  --months <count>          The number of simulated months, defaults to 1000000.\n"
+			"  --polls <count>           Budget window income queries per month, defaults to 4.\n"
+			"  --reload-interval <count> Reload the city every <count> months, defaults to 0 (never).\n"
+			"  --check-income-kernel <count>\n"
+			"                            Compare the fixed-point and double income calculations for <count>\n"
+			"                            random cities instead of running the simulation.\n"
+			"  --fuzz-saves <count>      Save and load <count> random objects of each save type with injected\n"
+			"                            stream errors and corrupted data, instead of running the simulation.\n"
+			"  --check-shared-effects    Check that modifying the ordinance effects through the ordinance's property\n"
+			"                            holder does not change the settings, instead of running the simulation.\n"
+			"                            Requires --settings with a crime effect multiplier other than 1.0.\n"
+			"  --settings <path>         The SC4CityLotteryOrdinance.ini file to load.\n"
+			"  --log <path>              Write a log file with all of the compiled in log options enabled.\n"
+			"  --log-mode <mode>         The log write mode: async (the default, like the plugin DLL), sync or trace.\n"
+			"  --log-max-size <bytes>    Write the text log through a memory-mapped file of this size, which is\n"
+			"                            rotated when it is full. Defaults to 0 (an unlimited ofstream).\n"
+			"  --log-dedup <on|off>      Collapse repeated log lines within each sim month, defaults to off.\n"
+			"  --log-monthly-limit <count>\n"
+			"                            The maximum number of ordinance API log lines per sim month, defaults to 0 (no limit).\n"
+			"  --trace <path>            Write a Chrome trace-event JSON file of the ordinance callbacks.\n"
+			"  --stats <calls|latency>   Print the number of calls to each ordinance entry point, latency also\n"
+			"                            measures the duration of each call.\n",
+			programName);
+	}
+
+	bool ParseOptions(int argc, char** argv, HarnessOptions& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* arg = argv[i];
+			const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+			if (std::strcmp(arg, "--help") == 0)
+			{
+				return false;
+			}
+
+			if (std::strcmp(arg, "--check-shared-effects") == 0)
+			{
+				options.checkSharedEffects = true;
+				continue;
+			}
+
+			if (!value)
+			{
+				std::fprintf(stderr, "Missing value for %s.\n", arg);
+				return false;
+			}
+
+			if (std::strcmp(arg, "--months") == 0)
+			{
+				options.months = std::strtoull(value, nullptr, 10);
+			}
+			else if (std::strcmp(arg, "--polls") == 0)
+			{
+				options.budgetPollCount = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--reload-interval") == 0)
+			{
+				options.cityReloadInterval = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--check-income-kernel") == 0)
+			{
+				options.incomeKernelCheckCount = std::strtoull(value, nullptr, 10);
+			}
+			else if (std::strcmp(arg, "--fuzz-saves") == 0)
+			{
+				options.saveFuzzIterations = std::strtoull(value, nullptr, 10);
+			}
+			else if (std::strcmp(arg, "--settings") == 0)
+			{
+				options.settingsPath = value;
+			}
+			else if (std::strcmp(arg, "--log") == 0)
+			{
+				options.logPath = value;
+			}
+			else if (std::strcmp(arg, "--trace") == 0)
+			{
+				options.tracePath = value;
+			}
+			else if (std::strcmp(arg, "--log-max-size") == 0)
+			{
+				options.logMaxFileSize = static_cast<size_t>(std::strtoull(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--log-dedup") == 0)
+			{
+				options.logDeduplication = std::strcmp(value, "on") == 0;
+			}
+			else if (std::strcmp(arg, "--log-monthly-limit") == 0)
+			{
+				options.logMonthlyLineLimit = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--stats") == 0)
+			{
+				if (std::strcmp(value, "calls") == 0)
+				{
+					options.printEntryPointStatistics = true;
+				}
+				else if (std::strcmp(value, "latency") == 0)
+				{
+					options.printEntryPointStatistics = true;
+					options.recordEntryPointLatency = true;
+				}
+				else
+				{
+					std::fprintf(stderr, "Unknown statistics mode: %s\n", value);
+					return false;
+				}
+			}
+			else if (std::strcmp(arg, "--log-mode") == 0)
+			{
+				if (std::strcmp(value, "async") == 0)
+				{
+					options.logWriteMode = LogWriteMode::Asynchronous;
+				}
+				else if (std::strcmp(value, "sync") == 0)
+				{
+					options.logWriteMode = LogWriteMode::Synchronous;
+				}
+				else if (std::strcmp(value, "trace") == 0)
+				{
+					options.logWriteMode = LogWriteMode::BinaryTrace;
+				}
+				else
+				{
+					std::fprintf(stderr, "Unknown log mode: %s\n", value);
+					return false;
+				}
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option: %s\n", arg);
+				return false;
+			}
+
+			i++;
+		}
+
+		return true;
+	}
+
+	// Compares the fixed-point income calculation with the original double-precision
+	// calculation for random cities. The populations are whole numbers below the
+	// specified limit, which is how the game reports them.
+	// Returns the largest difference between the two results.
+	uint64_t CheckIncomeKernel(uint64_t count, uint32_t maxPopulation, std::mt19937_64& random)
+	{
+		constexpr size_t GroupCount = 12;
+
+		std::uniform_int_distribution<int64_t> constantIncomeDistribution(-1000000, 1000000);
+		std::uniform_int_distribution<uint32_t> populationDistribution(0, maxPopulation);
+		std::uniform_real_distribution<float> factorDistribution(0.001f, 10.0f);
+		std::uniform_int_distribution<size_t> groupCountDistribution(0, GroupCount);
+
+		float populations[GroupCount]{};
+		float factors[GroupCount]{};
+		IncomeKernel::FixedPointFactor fixedPointFactors[GroupCount]{};
+
+		uint64_t mismatchCount = 0;
+		uint64_t maxDifference = 0;
+
+		for (uint64_t i = 0; i < count; i++)
+		{
+			const int64_t constantIncome = constantIncomeDistribution(random);
+			const size_t groupCount = groupCountDistribution(random);
+
+			for (size_t j = 0; j < groupCount; j++)
+			{
+				populations[j] = static_cast<float>(populationDistribution(random));
+				factors[j] = factorDistribution(random);
+				fixedPointFactors[j] = IncomeKernel::ToFixedPoint(factors[j]);
+			}
+
+			const int64_t fixedPointIncome = IncomeKernel::CalculateFixedPoint(constantIncome, populations, fixedPointFactors, groupCount);
+			const int64_t doubleIncome = IncomeKernel::CalculateDouble(constantIncome, populations, factors, groupCount);
+
+			if (fixedPointIncome != doubleIncome)
+			{
+				mismatchCount++;
+
+				const uint64_t difference = fixedPointIncome > doubleIncome
+					? static_cast<uint64_t>(fixedPointIncome - doubleIncome)
+					: static_cast<uint64_t>(doubleIncome - fixedPointIncome);
+
+				maxDifference = std::max(maxDifference, difference);
+			}
+		}
+
+		std::printf(
+			"populations <= %-10u cities: %llu, mismatches: %llu, max difference: %llu\n",
+			maxPopulation,
+			static_cast<unsigned long long>(count),
+			static_cast<unsigned long long>(mismatchCount),
+			static_cast<unsigned long long>(maxDifference));
+
+		return maxDifference;
+	}
+
+	constexpr uint32_t CrimeEffectMultiplierPropertyID = 0x28ed0380;
+
+	bool GetCrimeEffectMultiplier(cISCPropertyHolder& holder, float& value)
+	{
+		cISCProperty* property = holder.GetProperty(CrimeEffectMultiplierPropertyID);
+
+		if (!property)
+		{
+			return false;
+		}
+
+		const bool result = property->GetPropertyValue()->GetValFloat32(value);
+		property->Release();
+
+		return result;
+	}
+
+	void ClearFloatProperty(cISCProperty* property, void*)
+	{
+		property->GetPropertyValue()->SetValFloat32(0.0f);
+	}
+
+	// The ordinance shares its effects with the settings, modifying them through the
+	// properties that GetProperty and EnumProperties return must not change the settings.
+	bool CheckSharedOrdinanceEffects(const Settings& settings)
+	{
+		OrdinancePropertyHolder settingsEffects = settings.OrdinanceEffects();
+		float settingsValue = 0.0f;
+
+		if (!GetCrimeEffectMultiplier(settingsEffects, settingsValue))
+		{
+			std::fprintf(stderr, "The settings do not have a crime effect multiplier.\n");
+			return false;
+		}
+
+		CityLotteryOrdinance ordinance;
+		ordinance.UpdateOrdinanceData(settings);
+
+		cISCPropertyHolder* ordinanceEffects = ordinance.GetMiscProperties();
+
+		cISCProperty* property = ordinanceEffects->GetProperty(CrimeEffectMultiplierPropertyID);
+		property->GetPropertyValue()->SetValFloat32(settingsValue * 2.0f);
+		property->Release();
+
+		float ordinanceValue = 0.0f;
+		GetCrimeEffectMultiplier(*ordinanceEffects, ordinanceValue);
+
+		float valueAfterGetProperty = 0.0f;
+		settingsEffects = settings.OrdinanceEffects();
+		GetCrimeEffectMultiplier(settingsEffects, valueAfterGetProperty);
+
+		// Copy the ordinance effects to the settings again, and modify them through EnumProperties.
+		ordinance.UpdateOrdinanceData(settings);
+		ordinance.GetMiscProperties()->EnumProperties(ClearFloatProperty, nullptr);
+
+		float valueAfterEnumProperties = 0.0f;
+		settingsEffects = settings.OrdinanceEffects();
+		GetCrimeEffectMultiplier(settingsEffects, valueAfterEnumProperties);
+
+		std::printf(
+			"crime effect multiplier: settings %g, modified ordinance %g, settings after GetProperty %g, after EnumProperties %g\n",
+			settingsValue,
+			ordinanceValue,
+			valueAfterGetProperty,
+			valueAfterEnumProperties);
+
+		return ordinanceValue == settingsValue * 2.0f
+			&& valueAfterGetProperty == settingsValue
+			&& valueAfterEnumProperties == settingsValue;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	HarnessOptions options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (options.incomeKernelCheckCount > 0)
+	{
+		std::mt19937_64 random(0x5c4c17ee);
+
+		// Below 2^24 the populations and their products with the factors are exact
+		// in the double calculation, the only differences are from the rounding of
+		// the intermediate sums and of the factors to 1/2^32.
+		const uint64_t smallCityDifference = CheckIncomeKernel(options.incomeKernelCheckCount, (1 << 24) - 1, random);
+		CheckIncomeKernel(options.incomeKernelCheckCount, std::numeric_limits<int32_t>::max(), random);
+
+		return smallCityDifference <= 1 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (options.saveFuzzIterations > 0)
+	{
+		SaveFuzzer fuzzer(0x5c4c17ee);
+
+		return fuzzer.Run(options.saveFuzzIterations) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (!options.logPath.empty())
+	{
+		Logger& logger = Logger::GetInstance();
+
+		logger.Init(options.logPath, LogOptions::All, options.logWriteMode, options.logMaxFileSize);
+		logger.SetDeduplicationEnabled(options.logDeduplication);
+		logger.SetMonthlyLineLimit(LogOptions::OrdinanceAPI, options.logMonthlyLineLimit);
+		logger.SetMonthlyLineLimit(LogOptions::OrdinancePropertyAPI, options.logMonthlyLineLimit);
+	}
+
+	if (!options.tracePath.empty() && !TraceEventRecorder::GetInstance().Open(options.tracePath))
+	{
+		std::fprintf(stderr, "Failed to create the trace file.\n");
+		return EXIT_FAILURE;
+	}
+
+	EntryPointStatistics::GetInstance().SetLatencyHistogramsEnabled(options.recordEntryPointLatency);
+
+	Settings settings;
+
+	if (!options.settingsPath.empty())
+	{
+		try
+		{
+			settings.Load(options.settingsPath);
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "Failed to load the settings: %s\n", e.what());
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (options.checkSharedEffects)
+	{
+		return CheckSharedOrdinanceEffects(settings) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	CityLotteryOrdinance ordinance;
+	CityScenario scenario(ordinance, settings);
+
+	if (!scenario.LoadCity())
+	{
+		std::fprintf(stderr, "Failed to initialize the ordinance.\n");
+		return EXIT_FAILURE;
+	}
+
+	int64_t totalIncome = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (uint64_t month = 1; month <= options.months; month++)
+	{
+		totalIncome += scenario.SimulateMonth(options.budgetPollCount);
+
+		if (options.cityReloadInterval > 0 && (month % options.cityReloadInterval) == 0)
+		{
+			scenario.ShutdownCity();
+
+			if (!scenario.LoadCity())
+			{
+				std::fprintf(stderr, "Failed to reload the city at month %llu.\n", static_cast<unsigned long long>(month));
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	scenario.ShutdownCity();
+
+	const double elapsedSeconds = std::chrono::duration<double>(end - start).count();
+	const double nanosecondsPerMonth = options.months > 0 ? (elapsedSeconds * 1e9) / static_cast<double>(options.months) : 0.0;
+
+	std::printf("months:           %llu\n", static_cast<unsigned long long>(options.months));
+	std::printf("budget polls:     %u per month\n", options.budgetPollCount);
+	std::printf("elapsed:          %.3f s\n", elapsedSeconds);
+	std::printf("time per month:   %.1f ns\n", nanosecondsPerMonth);
+	std::printf("GetDemand calls:  %llu\n", static_cast<unsigned long long>(scenario.City().DemandSimulator().GetDemandCallCount()));
+	std::printf("total income:     %lld\n", static_cast<long long>(totalIncome));
+
+	TraceEventRecorder::GetInstance().Close();
+
+	if (options.printEntryPointStatistics)
+	{
+		std::printf("\n");
+
+		for (const std::string& line : EntryPointStatistics::GetInstance().FormatSummary())
+		{
+			std::printf("%s\n", line.c_str());
+		}
+	}
+
+	if (!options.logPath.empty())
+	{
+		Logger& logger = Logger::GetInstance();
+		logger.Shutdown();
+
+		std::printf("dropped log lines: %llu\n", static_cast<unsigned long long>(logger.GetDroppedLineCount()));
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryTraceFormat.h"
+#include <cstring>
+
+namespace
+{
+	enum class LengthModifier
+	{
+		None,
+		Char,
+		Short,
+		Long,
+		LongLong,
+		IntMax,
+		Size,
+		PtrDiff,
+		LongDouble,
+	};
+
+	LengthModifier ParseLengthModifier(const char*& position)
+	{
+		switch (*position)
+		{
+		case 'h':
+			if (position[1] == 'h')
+			{
+				position += 2;
+				return LengthModifier::Char;
+			}
+			position++;
+			return LengthModifier::Short;
+		case 'l':
+			if (position[1] == 'l')
+			{
+				position += 2;
+				return LengthModifier::LongLong;
+			}
+			position++;
+			return LengthModifier::Long;
+		case 'j':
+			position++;
+			return LengthModifier::IntMax;
+		case 'z':
+			position++;
+			return LengthModifier::Size;
+		case 't':
+			position++;
+			return LengthModifier::PtrDiff;
+		case 'L':
+			position++;
+			return LengthModifier::LongDouble;
+		default:
+			return LengthModifier::None;
+		}
+	}
+
+	bool GetSignedArgumentType(LengthModifier length, BinaryTraceFormat::ArgumentType& type)
+	{
+		using BinaryTraceFormat::ArgumentType;
+
+		switch (length)
+		{
+		case LengthModifier::None:
+		case LengthModifier::Char:
+		case LengthModifier::Short:
+			// The smaller types are promoted to int when they are passed through the varargs.
+			type = ArgumentType::Int;
+			return true;
+		case LengthModifier::Long:
+			type = ArgumentType::Long;
+			return true;
+		case LengthModifier::LongLong:
+			type = ArgumentType::LongLong;
+			return true;
+		case LengthModifier::IntMax:
+			type = ArgumentType::IntMax;
+			return true;
+		case LengthModifier::Size:
+		case LengthModifier::PtrDiff:
+			type = ArgumentType::PtrDiff;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool GetUnsignedArgumentType(LengthModifier length, BinaryTraceFormat::ArgumentType& type)
+	{
+		using BinaryTraceFormat::ArgumentType;
+
+		switch (length)
+		{
+		case LengthModifier::None:
+		case LengthModifier::Char:
+		case LengthModifier::Short:
+			type = ArgumentType::UnsignedInt;
+			return true;
+		case LengthModifier::Long:
+			type = ArgumentType::UnsignedLong;
+			return true;
+		case LengthModifier::LongLong:
+			type = ArgumentType::UnsignedLongLong;
+			return true;
+		case LengthModifier::IntMax:
+			type = ArgumentType::UIntMax;
+			return true;
+		case LengthModifier::Size:
+		case LengthModifier::PtrDiff:
+			type = ArgumentType::Size;
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
+bool BinaryTraceFormat::ParseFormat(const char* format, std::vector<FormatArgument>& arguments)
+{
+	arguments.clear();
+
+	const char* position = format;
+
+	while ((position = std::strchr(position, '%')) != nullptr)
+	{
+		position++;
+
+		if (*position == '%')
+		{
+			position++;
+			continue;
+		}
+
+		position += std::strspn(position, "-+ #0'");
+
+		if (*position == '*')
+		{
+			return false;
+		}
+
+		position += std::strspn(position, "0123456789");
+
+		if (*position == '.')
+		{
+			position++;
+
+			if (*position == '*')
+			{
+				return false;
+			}
+
+			position += std::strspn(position, "0123456789");
+		}
+
+		const LengthModifier length = ParseLengthModifier(position);
+		ArgumentType type = ArgumentType::Int;
+
+		switch (*position)
+		{
+		case 'd':
+		case 'i':
+			if (!GetSignedArgumentType(length, type))
+			{
+				return false;
+			}
+			break;
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+			if (!GetUnsignedArgumentType(length, type))
+			{
+				return false;
+			}
+			break;
+		case 'c':
+			if (length != LengthModifier::None)
+			{
+				return false;
+			}
+			type = ArgumentType::Int;
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			if (length != LengthModifier::None && length != LengthModifier::Long)
+			{
+				return false;
+			}
+			type = ArgumentType::Double;
+			break;
+		case 's':
+			if (length != LengthModifier::None)
+			{
+				return false;
+			}
+			type = ArgumentType::String;
+			break;
+		case 'p':
+			if (length != LengthModifier::None)
+			{
+				return false;
+			}
+			type = ArgumentType::Pointer;
+			break;
+		default:
+			return false;
+		}
+
+		position++;
+
+		arguments.push_back(FormatArgument{ type, static_cast<size_t>(position - format) });
+	}
+
+	return true;
+}
+
+bool BinaryTraceFormat::IsSigned(ArgumentType type)
+{
+	switch (type)
+	{
+	case ArgumentType::Int:
+	case ArgumentType::Long:
+	case ArgumentType::LongLong:
+	case ArgumentType::IntMax:
+	case ArgumentType::PtrDiff:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void BinaryTraceFormat::AppendVarint(std::string& output, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+
+	output.push_back(static_cast<char>(value));
+}
+
+bool BinaryTraceFormat::ReadVarint(const uint8_t*& input, const uint8_t* end, uint64_t& value)
+{
+	value = 0;
+
+	for (uint32_t shift = 0; shift < 64; shift += 7)
+	{
+		if (input == end)
+		{
+			return false;
+		}
+
+		const uint8_t byte = *input++;
+
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The layout of the binary trace log that is written by BinaryTraceWriter and
+// expanded back to text by the SC4LogDecoder tool.
+//
+// The file starts with the Magic bytes, a 16-bit version and the local time
+// that the trace was started at. It is followed by a sequence of records that
+// each start with a RecordType byte. All integers after the file header are
+// stored as LEB128 varints, signed values are zigzag encoded first.
+//
+// Each printf format string that is logged is stored once in a FormatDefinition
+// record, its ID is the call-site ID used by the Entry records. The string
+// arguments are stored once in StringDefinition records.
+namespace BinaryTraceFormat
+{
+	constexpr char Magic[8] = { 'S', 'C', '4', 'T', 'R', 'A', 'C', 'E' };
+	constexpr uint16_t Version = 1;
+
+	// The size of the file header: the magic, version and 4 16-bit time fields.
+	constexpr size_t FileHeaderSize = sizeof(Magic) + 2 + 8;
+
+	enum class RecordType : uint8_t
+	{
+		// varint id, varint length, format string bytes.
+		FormatDefinition = 1,
+		// varint id, varint length, string bytes.
+		StringDefinition = 2,
+		// varint sim month (year * 12 + month), applies to the following entries.
+		SimMonth = 3,
+		// varint length, text bytes. A log file header line, it has no timestamp.
+		HeaderLine = 4,
+		// varint format id, varint microseconds since the previous entry, followed
+		// by the arguments of the format string.
+		Entry = 5,
+		// varint microseconds since the previous entry, varint length, text bytes.
+		// Used for the lines with a format string that cannot be stored as an Entry.
+		TextLine = 6,
+	};
+
+	// The C type of a printf argument, this determines how the argument is read
+	// from the va_list and how it is passed back to snprintf by the decoder.
+	enum class ArgumentType : uint8_t
+	{
+		Int,
+		Long,
+		LongLong,
+		IntMax,
+		PtrDiff,
+		UnsignedInt,
+		UnsignedLong,
+		UnsignedLongLong,
+		UIntMax,
+		Size,
+		Double,
+		String,
+		Pointer,
+	};
+
+	struct FormatArgument
+	{
+		ArgumentType type;
+		// The offset of the character after the conversion specifier.
+		size_t end;
+	};
+
+	/**
+	 * @brief Parses the conversion specifiers of a printf format string.
+	 * @param format The format string.
+	 * @param arguments Receives the type and position of each argument.
+	 * @return True if the format string can be stored in the trace; otherwise, false.
+	 * Formats that use a '*' width or precision, %n, wide strings or long double are not supported.
+	*/
+	bool ParseFormat(const char* format, std::vector<FormatArgument>& arguments);
+
+	/**
+	 * @brief Determines if the argument type is stored as a zigzag encoded signed value.
+	 * @param type The argument type.
+	 * @return True if the argument type is signed; otherwise, false.
+	*/
+	bool IsSigned(ArgumentType type);
+
+	/**
+	 * @brief Appends a varint to the output.
+	 * @param output The output buffer.
+	 * @param value The value to write.
+	*/
+	void AppendVarint(std::string& output, uint64_t value);
+
+	/**
+	 * @brief Reads a varint from the input.
+	 * @param input The current input position, advanced past the varint.
+	 * @param end The end of the input.
+	 * @param value Receives the value.
+	 * @return True if the varint was read; otherwise, false.
+	*/
+	bool ReadVarint(const uint8_t*& input, const uint8_t* end, uint64_t& value);
+
+	inline uint64_t ZigZagEncode(int64_t value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	inline int64_t ZigZagDecode(uint64_t value)
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+}
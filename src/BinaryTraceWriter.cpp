@@ -0,0 +1,289 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryTraceWriter.h"
+#include "Platform.h"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+using BinaryTraceFormat::ArgumentType;
+using BinaryTraceFormat::RecordType;
+
+namespace
+{
+	// The records are collected in memory and written when the buffer reaches this size.
+	constexpr size_t FlushThreshold = 64 * 1024;
+
+	// The buffer used to format the lines that cannot be stored as an Entry record.
+	constexpr size_t TextLineBufferSize = 512;
+
+	// The maximum number of arguments in an Entry record.
+	constexpr size_t MaxEntryArguments = 16;
+
+	// The format used by WriteLine.
+	constexpr const char* MessageFormat = "%s";
+
+	void AppendUInt16(std::string& output, uint16_t value)
+	{
+		output.push_back(static_cast<char>(value & 0xff));
+		output.push_back(static_cast<char>(value >> 8));
+	}
+}
+
+BinaryTraceWriter::BinaryTraceWriter(std::ostream& stream)
+	: stream(stream),
+	  buffer(),
+	  formats(),
+	  strings(),
+	  nextFormatID(0),
+	  nextStringID(0),
+	  simMonth(0),
+	  recordedSimMonth(0),
+	  lastEntryTime(std::chrono::steady_clock::now())
+{
+	buffer.reserve(FlushThreshold + TextLineBufferSize);
+
+	const Platform::LocalTime startTime = Platform::GetLocalTime();
+
+	buffer.append(BinaryTraceFormat::Magic, sizeof(BinaryTraceFormat::Magic));
+	AppendUInt16(buffer, BinaryTraceFormat::Version);
+	AppendUInt16(buffer, startTime.hour);
+	AppendUInt16(buffer, startTime.minute);
+	AppendUInt16(buffer, startTime.second);
+	AppendUInt16(buffer, startTime.milliseconds);
+}
+
+void BinaryTraceWriter::SetSimMonth(uint32_t simMonth)
+{
+	this->simMonth = simMonth;
+}
+
+void BinaryTraceWriter::WriteHeaderLine(const char* const text)
+{
+	AppendRecordType(RecordType::HeaderLine);
+	AppendText(text, std::strlen(text));
+	CompleteRecord();
+}
+
+void BinaryTraceWriter::WriteLine(const char* const message)
+{
+	const FormatInfo& format = GetFormat(MessageFormat);
+	const uint32_t messageID = GetStringID(message);
+
+	AppendRecordType(RecordType::Entry);
+	BinaryTraceFormat::AppendVarint(buffer, format.id);
+	BinaryTraceFormat::AppendVarint(buffer, GetElapsedMicroseconds());
+	BinaryTraceFormat::AppendVarint(buffer, messageID);
+	CompleteRecord();
+}
+
+void BinaryTraceWriter::WriteLineFormatted(const char* const format, va_list args)
+{
+	const FormatInfo& formatInfo = GetFormat(format);
+
+	if (!formatInfo.supported || formatInfo.arguments.size() > MaxEntryArguments)
+	{
+		char text[TextLineBufferSize];
+
+		int length = std::vsnprintf(text, sizeof(text), format, args);
+
+		if (length < 0)
+		{
+			return;
+		}
+
+		AppendRecordType(RecordType::TextLine);
+		BinaryTraceFormat::AppendVarint(buffer, GetElapsedMicroseconds());
+		AppendText(text, std::min(static_cast<size_t>(length), sizeof(text) - 1));
+		CompleteRecord();
+		return;
+	}
+
+	// The arguments are collected first because the string arguments must be
+	// defined before the Entry record that uses them.
+	uint64_t values[MaxEntryArguments];
+	size_t valueCount = 0;
+
+	for (const BinaryTraceFormat::FormatArgument& argument : formatInfo.arguments)
+	{
+		uint64_t value = 0;
+
+		switch (argument.type)
+		{
+		case ArgumentType::Int:
+			value = BinaryTraceFormat::ZigZagEncode(va_arg(args, int));
+			break;
+		case ArgumentType::Long:
+			value = BinaryTraceFormat::ZigZagEncode(va_arg(args, long));
+			break;
+		case ArgumentType::LongLong:
+			value = BinaryTraceFormat::ZigZagEncode(va_arg(args, long long));
+			break;
+		case ArgumentType::IntMax:
+			value = BinaryTraceFormat::ZigZagEncode(va_arg(args, intmax_t));
+			break;
+		case ArgumentType::PtrDiff:
+			value = BinaryTraceFormat::ZigZagEncode(va_arg(args, ptrdiff_t));
+			break;
+		case ArgumentType::UnsignedInt:
+			value = va_arg(args, unsigned int);
+			break;
+		case ArgumentType::UnsignedLong:
+			value = va_arg(args, unsigned long);
+			break;
+		case ArgumentType::UnsignedLongLong:
+			value = va_arg(args, unsigned long long);
+			break;
+		case ArgumentType::UIntMax:
+			value = va_arg(args, uintmax_t);
+			break;
+		case ArgumentType::Size:
+			value = va_arg(args, size_t);
+			break;
+		case ArgumentType::Double:
+			value = std::bit_cast<uint64_t>(va_arg(args, double));
+			break;
+		case ArgumentType::String:
+			value = GetStringID(va_arg(args, const char*));
+			break;
+		case ArgumentType::Pointer:
+			value = reinterpret_cast<uintptr_t>(va_arg(args, void*));
+			break;
+		}
+
+		values[valueCount++] = value;
+	}
+
+	AppendRecordType(RecordType::Entry);
+	BinaryTraceFormat::AppendVarint(buffer, formatInfo.id);
+	BinaryTraceFormat::AppendVarint(buffer, GetElapsedMicroseconds());
+
+	for (size_t i = 0; i < valueCount; i++)
+	{
+		if (formatInfo.arguments[i].type == ArgumentType::Double)
+		{
+			// The doubles are stored as 8 little-endian bytes.
+			for (int shift = 0; shift < 64; shift += 8)
+			{
+				buffer.push_back(static_cast<char>((values[i] >> shift) & 0xff));
+			}
+		}
+		else
+		{
+			BinaryTraceFormat::AppendVarint(buffer, values[i]);
+		}
+	}
+
+	CompleteRecord();
+}
+
+void BinaryTraceWriter::Flush()
+{
+	if (!buffer.empty())
+	{
+		stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		buffer.clear();
+	}
+
+	stream.flush();
+}
+
+const BinaryTraceWriter::FormatInfo& BinaryTraceWriter::GetFormat(const char* const format)
+{
+	auto it = formats.find(format);
+
+	if (it != formats.end() && it->second.text == format)
+	{
+		return it->second;
+	}
+
+	FormatInfo& info = formats[format];
+	info.id = nextFormatID++;
+	info.text = format;
+	info.supported = BinaryTraceFormat::ParseFormat(format, info.arguments);
+
+	if (info.supported)
+	{
+		AppendRecordType(RecordType::FormatDefinition);
+		BinaryTraceFormat::AppendVarint(buffer, info.id);
+		AppendText(info.text.c_str(), info.text.size());
+	}
+
+	return info;
+}
+
+uint32_t BinaryTraceWriter::GetStringID(const char* const value)
+{
+	if (!value)
+	{
+		return GetStringID("(null)");
+	}
+
+	auto it = strings.find(value);
+
+	// The string is defined again if the pointer is reused for a different string.
+	if (it != strings.end() && it->second.text == value)
+	{
+		return it->second.id;
+	}
+
+	StringInfo& info = strings[value];
+	info.id = nextStringID++;
+	info.text = value;
+
+	AppendRecordType(RecordType::StringDefinition);
+	BinaryTraceFormat::AppendVarint(buffer, info.id);
+	AppendText(info.text.c_str(), info.text.size());
+
+	return info.id;
+}
+
+uint64_t BinaryTraceWriter::GetElapsedMicroseconds()
+{
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - lastEntryTime);
+
+	// The remainder is carried over to the next entry so that the deltas do not drift.
+	lastEntryTime += elapsed;
+
+	return static_cast<uint64_t>(elapsed.count());
+}
+
+void BinaryTraceWriter::AppendRecordType(RecordType type)
+{
+	if (simMonth != recordedSimMonth)
+	{
+		recordedSimMonth = simMonth;
+
+		buffer.push_back(static_cast<char>(RecordType::SimMonth));
+		BinaryTraceFormat::AppendVarint(buffer, simMonth);
+	}
+
+	buffer.push_back(static_cast<char>(type));
+}
+
+void BinaryTraceWriter::AppendText(const char* const text, size_t length)
+{
+	BinaryTraceFormat::AppendVarint(buffer, length);
+	buffer.append(text, length);
+}
+
+void BinaryTraceWriter::CompleteRecord()
+{
+	if (buffer.size() >= FlushThreshold)
+	{
+		stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		buffer.clear();
+	}
+}
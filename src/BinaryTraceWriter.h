@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "BinaryTraceFormat.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Records the log lines as compact binary entries, see BinaryTraceFormat.h.
+// The format strings are expected to be string literals, each distinct format
+// string pointer is treated as a separate call site.
+class BinaryTraceWriter
+{
+public:
+
+	/**
+	 * @brief Constructs an instance of the class and writes the file header.
+	 * @param stream The binary output stream, it must outlive this instance.
+	*/
+	explicit BinaryTraceWriter(std::ostream& stream);
+
+	/**
+	 * @brief Sets the simulation month that is recorded for the following entries.
+	 * @param simMonth The simulation month, year * 12 + month.
+	*/
+	void SetSimMonth(uint32_t simMonth);
+
+	void WriteHeaderLine(const char* const text);
+
+	void WriteLine(const char* const message);
+
+	void WriteLineFormatted(const char* const format, va_list args);
+
+	/**
+	 * @brief Writes the buffered records to the output stream.
+	*/
+	void Flush();
+
+private:
+
+	struct FormatInfo
+	{
+		uint32_t id;
+		bool supported;
+		std::string text;
+		std::vector<BinaryTraceFormat::FormatArgument> arguments;
+	};
+
+	struct StringInfo
+	{
+		uint32_t id;
+		std::string text;
+	};
+
+	const FormatInfo& GetFormat(const char* const format);
+	uint32_t GetStringID(const char* const value);
+	uint64_t GetElapsedMicroseconds();
+	void AppendRecordType(BinaryTraceFormat::RecordType type);
+	void AppendText(const char* const text, size_t length);
+	void CompleteRecord();
+
+	std::ostream& stream;
+	std::string buffer;
+	std::unordered_map<const char*, FormatInfo> formats;
+	std::unordered_map<const char*, StringInfo> strings;
+	uint32_t nextFormatID;
+	uint32_t nextStringID;
+	uint32_t simMonth;
+	uint32_t recordedSimMonth;
+	std::chrono::steady_clock::time_point lastEntryTime;
+};
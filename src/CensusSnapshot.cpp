@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "CensusSnapshot.h"
+#include "cISC4Demand.h"
+#include "cISC4DemandSimulator.h"
+
+namespace
+{
+	constexpr uint32_t CityCensusIndex = 0;
+}
+
+CensusReader::CensusReader()
+	: pDemandSimulator(nullptr),
+	  demandGroups()
+{
+}
+
+void CensusReader::SetDemandGroups(const std::vector<PopulationIncomeFactor>& incomeFactors)
+{
+	// The settings are applied every time a city is loaded, the cached demand
+	// pointers are kept when the groups have not changed.
+	if (incomeFactors.size() == demandGroups.size())
+	{
+		bool groupsChanged = false;
+
+		for (size_t i = 0; i < demandGroups.size(); i++)
+		{
+			if (demandGroups[i].demandGroupID != incomeFactors[i].demandGroupID)
+			{
+				groupsChanged = true;
+				break;
+			}
+		}
+
+		if (!groupsChanged)
+		{
+			return;
+		}
+	}
+
+	demandGroups.clear();
+	demandGroups.reserve(incomeFactors.size());
+
+	for (const PopulationIncomeFactor& item : incomeFactors)
+	{
+		demandGroups.push_back(DemandGroup{ item.demandGroupID, nullptr });
+	}
+
+	Attach(pDemandSimulator);
+}
+
+void CensusReader::Attach(cISC4DemandSimulator* pDemandSimulator)
+{
+	this->pDemandSimulator = pDemandSimulator;
+
+	for (DemandGroup& group : demandGroups)
+	{
+		group.demand = pDemandSimulator ? pDemandSimulator->GetDemand(group.demandGroupID, CityCensusIndex) : nullptr;
+	}
+}
+
+void CensusReader::Update(CensusSnapshot& snapshot, uint32_t simMonth)
+{
+	if (simMonth != 0 && snapshot.simMonth == simMonth && snapshot.populations.size() == demandGroups.size())
+	{
+		return;
+	}
+
+	snapshot.simMonth = simMonth;
+	snapshot.populations.resize(demandGroups.size());
+
+	for (size_t i = 0; i < demandGroups.size(); i++)
+	{
+		snapshot.populations[i] = GetSupplyValue(demandGroups[i]);
+	}
+}
+
+float CensusReader::GetSupplyValue(DemandGroup& group)
+{
+	// A demand group that did not exist when the city was loaded is looked up again.
+	if (!group.demand && pDemandSimulator)
+	{
+		group.demand = pDemandSimulator->GetDemand(group.demandGroupID, CityCensusIndex);
+	}
+
+	return group.demand ? group.demand->QuerySupplyValue() : 0.0f;
+}
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "PopulationIncomeFactor.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class cISC4Demand;
+class cISC4DemandSimulator;
+
+// The city census values that the ordinances use, read from the demand
+// simulator once per in-game month.
+struct CensusSnapshot
+{
+	/**
+	 * @brief The in-game month that the snapshot was taken in, zero if the
+	 * snapshot has not been taken.
+	*/
+	uint32_t simMonth;
+
+	/**
+	 * @brief The population of each demand group, in the order that the
+	 * groups were passed to CensusReader::SetDemandGroups.
+	*/
+	std::vector<float> populations;
+};
+
+// Takes census snapshots from the demand simulator.
+// The cISC4Demand pointers for the census groups are looked up once when the
+// city is loaded, so each snapshot is one QuerySupplyValue call per group.
+class CensusReader
+{
+public:
+
+	CensusReader();
+
+	/**
+	 * @brief Sets the demand groups that are included in the snapshot.
+	 * @param incomeFactors The income factors, in the order that the snapshot
+	 * populations will use.
+	*/
+	void SetDemandGroups(const std::vector<PopulationIncomeFactor>& incomeFactors);
+
+	/**
+	 * @brief Looks up the census demand groups in the specified demand simulator.
+	 * @param pDemandSimulator The city's demand simulator, or nullptr when the city
+	 * is shutting down.
+	*/
+	void Attach(cISC4DemandSimulator* pDemandSimulator);
+
+	/**
+	 * @brief Updates the snapshot if it was taken in a different in-game month.
+	 * @param snapshot The snapshot to update.
+	 * @param simMonth The current in-game month, zero forces an update.
+	*/
+	void Update(CensusSnapshot& snapshot, uint32_t simMonth);
+
+private:
+
+	struct DemandGroup
+	{
+		uint32_t demandGroupID;
+		cISC4Demand* demand;
+	};
+
+	float GetSupplyValue(DemandGroup& group);
+
+	cISC4DemandSimulator* pDemandSimulator;
+	std::vector<DemandGroup> demandGroups;
+};
@@ -11,10 +11,13 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "CityLotteryOrdinance.h"
+#include "EntryPointStatistics.h"
 #include "ISettings.h"
+#include "IncomeKernel.h"
+#include "SaveRecordCodec.h"
+#include "TraceEventRecorder.h"
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
-#include "cISC4Demand.h"
 #include "cISC4DemandSimulator.h"
 #include "cISC4App.h"
 #include "cISC4Region.h"
@@ -27,7 +30,7 @@ namespace
 {
 	OrdinancePropertyHolder CreateDefaultOrdinanceEffects()
 	{
-		OrdinancePropertyHolder properties;
+		OrdinancePropertyHolder properties(OrdinancePropertyHolder::DuplicatePropertyMode::Replace);
 
 		// Positive Effects:
 
@@ -62,219 +65,194 @@ CityLotteryOrdinance::CityLotteryOrdinance()
 		/* monthly income factor */   0.0f, // unused
 		/* income ordinance */		  true,
 		CreateDefaultOrdinanceEffects()),
-	pDemandSimulator(nullptr),
-	residentialLowWealthIncomeFactor(0.05f),
-	residentialMedWealthIncomeFactor(0.03f),
-	residentialHighWealthIncomeFactor(0.01f)
+	censusReader(),
+	census{},
+	populationIncomeFactors(),
+	fixedPointIncomeFactors(),
+	settingsGeneration(0),
+	incomeCache{}
 {
+	SetResidentialIncomeFactors(0.05f, 0.03f, 0.01f);
 }
 
 void CityLotteryOrdinance::UpdateOrdinanceData(const ISettings& settings)
 {
 	this->monthlyConstantIncome = settings.MonthlyConstantIncome();
-	this->residentialLowWealthIncomeFactor = settings.ResidentialLowWealthFactor();
-	this->residentialMedWealthIncomeFactor = settings.ResidentialMedWealthFactor();
-	this->residentialHighWealthIncomeFactor = settings.ResidentialHighWealthFactor();
+	SetPopulationIncomeFactors(settings.PopulationIncomeFactors());
 	this->miscProperties = settings.OrdinanceEffects();
+	settingsGeneration++;
 }
 
-int64_t CityLotteryOrdinance::GetCurrentMonthlyIncome()
+int64_t CityLotteryOrdinance::CalculateCurrentMonthlyIncome()
 {
-	const int64_t monthlyConstantIncome = GetMonthlyConstantIncome();
+	TraceEventScope traceScope("CityLotteryOrdinance::CalculateCurrentMonthlyIncome");
 
-	double monthlyIncome = static_cast<double>(monthlyConstantIncome);
+	const uint32_t simMonth = GetCurrentSimMonth();
 
-	// Add the monthly income for each of the residential wealth groups.
-	// If the income factor is 0.0 for any group they will not participate in the city lottery.
-
-	if (residentialLowWealthIncomeFactor > 0.0f)
+	// A sim month of zero means that the ordinance is not attached to a city, the
+	// income is not cached in that case.
+	if (simMonth == 0
+		|| incomeCache.simMonth != simMonth
+		|| incomeCache.settingsGeneration != settingsGeneration)
 	{
-		const double lowWealthPopulation = GetCityPopulation(0x1011);
-		if (lowWealthPopulation > 0.0)
-		{
-			const double lotteryPopulationIncome = lowWealthPopulation * static_cast<double>(residentialLowWealthIncomeFactor);
+		incomeCache.simMonth = simMonth;
+		incomeCache.settingsGeneration = settingsGeneration;
 
-			monthlyIncome += lotteryPopulationIncome;
-		}
+		censusReader.Update(census, simMonth);
+		incomeCache.income = CalculateMonthlyIncome();
 	}
-
-	if (residentialMedWealthIncomeFactor > 0.0f)
+	else
 	{
-		const double medWealthPopulation = GetCityPopulation(0x1021);
-		if (medWealthPopulation > 0.0)
-		{
-			const double lotteryPopulationIncome = medWealthPopulation * static_cast<double>(residentialMedWealthIncomeFactor);
-
-			monthlyIncome += lotteryPopulationIncome;
-		}
+		logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
+			"%s: cached=%lld",
+			__FUNCTION__,
+			incomeCache.income);
 	}
 
-	if (residentialHighWealthIncomeFactor > 0.0f)
-	{
-		const double highWealthPopulation = GetCityPopulation(0x1031);
-		if (highWealthPopulation > 0.0)
-		{
-			const double lotteryPopulationIncome = highWealthPopulation * static_cast<double>(residentialHighWealthIncomeFactor);
-
-			monthlyIncome += lotteryPopulationIncome;
-		}
-	}
+	return incomeCache.income;
+}
 
-	int64_t monthlyIncomeInteger = 0;
+int64_t CityLotteryOrdinance::CalculateMonthlyIncome()
+{
+	// Add the monthly income for each of the census groups. The groups with an income
+	// factor of 0.0 were removed when the settings were loaded, and a negative population
+	// contributes nothing.
+	const size_t groupCount = fixedPointIncomeFactors.size();
 
-	if (monthlyIncome < std::numeric_limits<int64_t>::min())
-	{
-		monthlyIncomeInteger = std::numeric_limits<int64_t>::min();
-	}
-	else if (monthlyIncome > std::numeric_limits<int64_t>::max())
-	{
-		monthlyIncomeInteger = std::numeric_limits<int64_t>::max();
-	}
-	else
-	{
-		monthlyIncomeInteger = static_cast<int64_t>(monthlyIncome);
-	}
+	const int64_t monthlyIncomeInteger = IncomeKernel::CalculateFixedPoint(
+		monthlyConstantIncome,
+		census.populations.data(),
+		fixedPointIncomeFactors.data(),
+		groupCount);
 
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
-		"%s: monthly income: constant=%lld, R$ factor=%f, R$$ factor=%f, R$$$ factor=%f, current=%lld",
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
+		"%s: monthly income: constant=%lld, census groups=%zu, current=%lld",
 		__FUNCTION__,
 		monthlyConstantIncome,
-		residentialLowWealthIncomeFactor,
-		residentialMedWealthIncomeFactor,
-		residentialHighWealthIncomeFactor,
+		groupCount,
 		monthlyIncomeInteger);
 
 	return monthlyIncomeInteger;
 }
 
-bool CityLotteryOrdinance::PostCityInit(cISC4City* pCity)
+float CityLotteryOrdinance::GetPopulationIncomeFactor(uint32_t demandGroupID) const
 {
-	bool result = OrdinanceBase::PostCityInit(pCity);
-
-	if (result)
+	for (const PopulationIncomeFactor& item : populationIncomeFactors)
 	{
-		pDemandSimulator = pCity->GetDemandSimulator();
-		result = pDemandSimulator != nullptr;
+		if (item.demandGroupID == demandGroupID)
+		{
+			return item.factor;
+		}
 	}
 
-	return result;
+	return 0.0f;
 }
 
-bool CityLotteryOrdinance::PreCityShutdown(cISC4City* pCity)
+void CityLotteryOrdinance::SetPopulationIncomeFactors(const std::vector<PopulationIncomeFactor>& factors)
 {
-	bool result = OrdinanceBase::PreCityShutdown(pCity);
-	pDemandSimulator = nullptr;
+	populationIncomeFactors = factors;
 
-	return result;
-}
+	// The factors are converted to fixed-point once, when they are set.
+	fixedPointIncomeFactors.clear();
+	fixedPointIncomeFactors.reserve(populationIncomeFactors.size());
 
-bool CityLotteryOrdinance::Write(cIGZOStream& stream)
-{
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
-
-	if (stream.GetError() != 0)
+	for (const PopulationIncomeFactor& item : populationIncomeFactors)
 	{
-		return false;
+		fixedPointIncomeFactors.push_back(IncomeKernel::ToFixedPoint(item.factor));
 	}
 
-	const uint32_t version = 1;
-	if (!stream.SetUint32(version))
-	{
-		return false;
-	}
+	censusReader.SetDemandGroups(populationIncomeFactors);
+	census.simMonth = 0;
+}
 
-	if (!stream.SetUint32(clsid))
-	{
-		return false;
-	}
+void CityLotteryOrdinance::SetResidentialIncomeFactors(float lowWealthFactor, float medWealthFactor, float highWealthFactor)
+{
+	// The residential factors replace the existing residential entries, the entries
+	// for the other census groups are kept.
+	std::vector<PopulationIncomeFactor> factors;
+	factors.reserve(populationIncomeFactors.size() + 3);
 
-	if (!stream.SetGZStr(name))
+	const std::array<PopulationIncomeFactor, 3> residentialFactors =
 	{
-		return false;
-	}
+		PopulationIncomeFactor{ CensusGroupID::ResidentialLowWealth, lowWealthFactor },
+		PopulationIncomeFactor{ CensusGroupID::ResidentialMedWealth, medWealthFactor },
+		PopulationIncomeFactor{ CensusGroupID::ResidentialHighWealth, highWealthFactor },
+	};
 
-	if (!stream.SetGZStr(description))
+	for (const PopulationIncomeFactor& item : residentialFactors)
 	{
-		return false;
+		if (item.factor > 0.0f)
+		{
+			factors.push_back(item);
+		}
 	}
 
-	if (!stream.SetSint64(enactmentIncome))
+	for (const PopulationIncomeFactor& item : populationIncomeFactors)
 	{
-		return false;
+		if (item.demandGroupID != CensusGroupID::ResidentialLowWealth
+			&& item.demandGroupID != CensusGroupID::ResidentialMedWealth
+			&& item.demandGroupID != CensusGroupID::ResidentialHighWealth)
+		{
+			factors.push_back(item);
+		}
 	}
 
-	if (!stream.SetSint64(retracmentIncome))
-	{
-		return false;
-	}
+	SetPopulationIncomeFactors(factors);
+}
 
-	if (!stream.SetSint64(retracmentIncome))
-	{
-		return false;
-	}
+bool CityLotteryOrdinance::PostCityInit(cISC4City* pCity)
+{
+	TraceEventScope traceScope("CityLotteryOrdinance::PostCityInit");
 
-	if (!stream.SetSint64(monthlyConstantIncome))
-	{
-		return false;
-	}
+	bool result = OrdinanceBase::PostCityInit(pCity);
 
-	if (!stream.SetSint64(monthlyAdjustedIncome))
+	if (result)
 	{
-		return false;
-	}
+		cISC4DemandSimulator* pDemandSimulator = pCity->GetDemandSimulator();
 
-	if (!stream.SetFloat32(residentialLowWealthIncomeFactor))
-	{
-		return false;
-	}
-
-	if (!stream.SetFloat32(residentialMedWealthIncomeFactor))
-	{
-		return false;
+		censusReader.Attach(pDemandSimulator);
+		census.simMonth = 0;
+		result = pDemandSimulator != nullptr;
 	}
 
-	if (!stream.SetFloat32(residentialHighWealthIncomeFactor))
-	{
-		return false;
-	}
+	settingsGeneration++;
 
-	if (!WriteBool(stream, isIncomeOrdinance))
-	{
-		return false;
-	}
+	return result;
+}
 
-	if (!miscProperties.Write(stream))
-	{
-		return false;
-	}
+bool CityLotteryOrdinance::PreCityShutdown(cISC4City* pCity)
+{
+	bool result = OrdinanceBase::PreCityShutdown(pCity);
+	censusReader.Attach(nullptr);
+	settingsGeneration++;
 
-	if (!WriteBool(stream, initialized))
-	{
-		return false;
-	}
+	return result;
+}
 
-	if (!WriteBool(stream, available))
-	{
-		return false;
-	}
+bool CityLotteryOrdinance::Write(cIGZOStream& stream)
+{
+	EntryPointScope scope(EntryPoint::OrdinanceWrite);
+	TraceEventScope traceScope("CityLotteryOrdinance::Write");
 
-	if (!WriteBool(stream, on))
-	{
-		return false;
-	}
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
-	if (!WriteBool(stream, enabled))
+	if (stream.GetError() != 0)
 	{
 		return false;
 	}
 
-	return true;
+	return WriteTaggedRecord(stream);
 }
 
 bool CityLotteryOrdinance::Read(cIGZIStream& stream)
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceRead);
+	TraceEventScope traceScope("CityLotteryOrdinance::Read");
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
+
+	// The saved income factors replace the current values.
+	settingsGeneration++;
 
 	if (stream.GetError() != 0)
 	{
@@ -282,11 +260,37 @@ bool CityLotteryOrdinance::Read(cIGZIStream& stream)
 	}
 
 	uint32_t version = 0;
-	if (!stream.GetUint32(version) || version != 1)
+	if (!stream.GetUint32(version))
 	{
 		return false;
 	}
 
+	bool result = false;
+
+	switch (version)
+	{
+	case 1:
+		result = ReadVersion1(stream);
+		break;
+	default:
+		// A newer version is read by skipping the sections that this build does not know.
+		if (version >= TaggedSaveVersion)
+		{
+			result = ReadTaggedRecord(stream);
+		}
+		break;
+	}
+
+	if (result)
+	{
+		haveDeserialized = true;
+	}
+
+	return result;
+}
+
+bool CityLotteryOrdinance::ReadVersion1(cIGZIStream& stream)
+{
 	if (!stream.GetUint32(clsid))
 	{
 		return false;
@@ -327,6 +331,10 @@ bool CityLotteryOrdinance::Read(cIGZIStream& stream)
 		return false;
 	}
 
+	float residentialLowWealthIncomeFactor = 0.0f;
+	float residentialMedWealthIncomeFactor = 0.0f;
+	float residentialHighWealthIncomeFactor = 0.0f;
+
 	if (!stream.GetFloat32(residentialLowWealthIncomeFactor))
 	{
 		return false;
@@ -342,12 +350,17 @@ bool CityLotteryOrdinance::Read(cIGZIStream& stream)
 		return false;
 	}
 
+	SetResidentialIncomeFactors(
+		residentialLowWealthIncomeFactor,
+		residentialMedWealthIncomeFactor,
+		residentialHighWealthIncomeFactor);
+
 	if (!ReadBool(stream, isIncomeOrdinance))
 	{
 		return false;
 	}
 
-	if (!miscProperties.Read(stream))
+	if (!miscProperties.ReadVersion1(stream))
 	{
 		return false;
 	}
@@ -372,32 +385,55 @@ bool CityLotteryOrdinance::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	haveDeserialized = true;
 	return true;
 }
 
-uint32_t CityLotteryOrdinance::GetGZCLSID()
+bool CityLotteryOrdinance::WriteSaveSections(SaveRecordWriter& writer) const
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	if (!OrdinanceBase::WriteSaveSections(writer))
+	{
+		return false;
+	}
 
-	return kCityLotteryOrdianceCLSID;
+	const size_t section = writer.BeginSection(SaveSectionResidentialIncomeFactors);
+	writer.WriteFloat32(GetPopulationIncomeFactor(CensusGroupID::ResidentialLowWealth));
+	writer.WriteFloat32(GetPopulationIncomeFactor(CensusGroupID::ResidentialMedWealth));
+	writer.WriteFloat32(GetPopulationIncomeFactor(CensusGroupID::ResidentialHighWealth));
+	writer.EndSection(section);
+
+	return true;
 }
 
-float CityLotteryOrdinance::GetCityPopulation(uint32_t groupID)
+bool CityLotteryOrdinance::ReadSaveSection(uint16_t tag, SaveRecordReader& section)
 {
-	float value = 0.0f;
-
-	if (pDemandSimulator)
+	if (tag != SaveSectionResidentialIncomeFactors)
 	{
-		constexpr uint32_t cityCensusIndex = 0;
+		return OrdinanceBase::ReadSaveSection(tag, section);
+	}
 
-		const cISC4Demand* demand = pDemandSimulator->GetDemand(groupID, cityCensusIndex);
+	float residentialLowWealthIncomeFactor = 0.0f;
+	float residentialMedWealthIncomeFactor = 0.0f;
+	float residentialHighWealthIncomeFactor = 0.0f;
 
-		if (demand)
-		{
-			value = demand->QuerySupplyValue();
-		}
+	if (!section.ReadFloat32(residentialLowWealthIncomeFactor)
+		|| !section.ReadFloat32(residentialMedWealthIncomeFactor)
+		|| !section.ReadFloat32(residentialHighWealthIncomeFactor))
+	{
+		return false;
 	}
 
-	return value;
+	SetResidentialIncomeFactors(
+		residentialLowWealthIncomeFactor,
+		residentialMedWealthIncomeFactor,
+		residentialHighWealthIncomeFactor);
+	return true;
+}
+
+uint32_t CityLotteryOrdinance::GetGZCLSID()
+{
+	EntryPointScope scope(EntryPoint::OrdinanceGetGZCLSID);
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
+
+	return kCityLotteryOrdianceCLSID;
 }
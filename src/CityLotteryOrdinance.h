@@ -12,6 +12,10 @@
 
 #pragma once
 #include "OrdinanceBase.h"
+#include "CensusSnapshot.h"
+#include "IncomeKernel.h"
+#include "PopulationIncomeFactor.h"
+#include <vector>
 
 class ISettings;
 
@@ -23,8 +27,6 @@ public:
 
 	void UpdateOrdinanceData(const ISettings& settings);
 
-	int64_t GetCurrentMonthlyIncome() override;
-
 	bool PostCityInit(cISC4City* pCity) override;
 
 	bool PreCityShutdown(cISC4City* pCity) override;
@@ -35,13 +37,37 @@ public:
 
 	uint32_t GetGZCLSID() override;
 
+protected:
+
+	int64_t CalculateCurrentMonthlyIncome() override;
+
+	bool WriteSaveSections(SaveRecordWriter& writer) const override;
+	bool ReadSaveSection(uint16_t tag, SaveRecordReader& section) override;
+
 private:
 
-	float GetCityPopulation(uint32_t groupID);
+	bool ReadVersion1(cIGZIStream& stream);
+
+	int64_t CalculateMonthlyIncome();
+	float GetPopulationIncomeFactor(uint32_t demandGroupID) const;
+	void SetPopulationIncomeFactors(const std::vector<PopulationIncomeFactor>& factors);
+	void SetResidentialIncomeFactors(float lowWealthFactor, float medWealthFactor, float highWealthFactor);
+
+	// The income is only recalculated when the in-game month or the
+	// ordinance configuration changes, the game queries it many times
+	// per month from the budget window and the ordinance menu.
+	struct MonthlyIncomeCache
+	{
+		uint32_t simMonth;
+		uint32_t settingsGeneration;
+		int64_t income;
+	};
 
-	cISC4DemandSimulator* pDemandSimulator;
-	float residentialLowWealthIncomeFactor;
-	float residentialMedWealthIncomeFactor;
-	float residentialHighWealthIncomeFactor;
+	CensusReader censusReader;
+	CensusSnapshot census;
+	std::vector<PopulationIncomeFactor> populationIncomeFactors;
+	std::vector<IncomeKernel::FixedPointFactor> fixedPointIncomeFactors;
+	uint32_t settingsGeneration;
+	MonthlyIncomeCache incomeCache;
 };
 
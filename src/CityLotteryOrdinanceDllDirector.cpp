@@ -12,8 +12,12 @@
 
 #include "version.h"
 #include "CityLotteryOrdinance.h"
+#include "EntryPointStatistics.h"
 #include "Logger.h"
+#include "Platform.h"
+#include "RegisteredOrdinanceDump.h"
 #include "Settings.h"
+#include "TraceEventRecorder.h"
 #include "cIGZFrameWork.h"
 #include "cIGZApp.h"
 #include "cIGZLanguageManager.h"
@@ -39,9 +43,6 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <Windows.h>
-#include "wil/resource.h"
-#include "wil/win32_helpers.h"
 
 static constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
 static constexpr uint32_t kSC4MessagePreCityShutdown = 0x26D31EC2;
@@ -50,6 +51,14 @@ static constexpr uint32_t kCityLotteryOrdinanceDirectorID = 0xc8f8cd0f;
 
 static constexpr std::string_view PluginConfigFileName = "SC4CityLotteryOrdinance.ini";
 static constexpr std::string_view PluginLogFileName = "SC4CityLotteryOrdinance.log";
+static constexpr std::string_view PluginTraceFileName = "SC4CityLotteryOrdinance.trace.json";
+
+// The diagnostic builds write much more to the log, it is limited to two 32 MB files.
+static constexpr size_t DiagnosticLogMaxFileSize = 32 * 1024 * 1024;
+
+// The game polls the ordinance API many times per month, the lines that are written
+// for each of the API categories are limited per sim month.
+static constexpr uint32_t DiagnosticLogMonthlyLineLimit = 1000;
 
 class CityLotteryOrdinanceDllDirector : public cRZMessage2COMDirector
 {
@@ -57,7 +66,7 @@ public:
 
 	CityLotteryOrdinanceDllDirector()
 	{
-		std::filesystem::path dllFolderPath = GetDllFolderPath();
+		std::filesystem::path dllFolderPath = Platform::GetModuleFolderPath();
 
 		configFilePath = dllFolderPath;
 		configFilePath /= PluginConfigFileName;
@@ -66,8 +75,33 @@ public:
 		logFilePath /= PluginLogFileName;
 
 		Logger& logger = Logger::GetInstance();
-		logger.Init(logFilePath, LogOptions::Errors);
+		if constexpr (IsLogCategoryCompiled<LogOptions::OrdinanceAPI>())
+		{
+			logger.Init(
+				logFilePath,
+				LogOptions::Errors | LogOptions::EntryPointStatistics | LogOptions::DumpRegisteredOrdinances,
+				LogWriteMode::Asynchronous,
+				DiagnosticLogMaxFileSize);
+		}
+		else
+		{
+			logger.Init(logFilePath, LogOptions::Errors | LogOptions::EntryPointStatistics, LogWriteMode::Asynchronous);
+		}
+
+		logger.SetDeduplicationEnabled(true);
+		logger.SetMonthlyLineLimit(LogOptions::OrdinanceAPI, DiagnosticLogMonthlyLineLimit);
+		logger.SetMonthlyLineLimit(LogOptions::OrdinancePropertyAPI, DiagnosticLogMonthlyLineLimit);
 		logger.WriteLogFileHeader("SC4CityLotteryOrdinance v" PLUGIN_VERSION_STR);
+
+		// The diagnostic builds also record a trace of the ordinance callbacks, which
+		// can be opened in Perfetto.
+		if constexpr (IsLogCategoryCompiled<LogOptions::OrdinanceAPI>())
+		{
+			std::filesystem::path traceFilePath = dllFolderPath;
+			traceFilePath /= PluginTraceFileName;
+
+			TraceEventRecorder::GetInstance().Open(traceFilePath);
+		}
 	}
 
 	uint32_t GetDirectorID() const
@@ -81,7 +115,7 @@ public:
 		// the framework calls this method before OnStart or any of the hook callbacks.
 		// This method is called once when initializing a director, the list of class IDs
 		// it returns is cached by the framework.
-		pCallback(cityLotteryOrdinance.GetID(), 0, pContext);
+		pCallback(cityLotteryOrdinance.GetState().id, 0, pContext);
 	}
 
 	bool GetClassObject(uint32_t rclsid, uint32_t riid, void** ppvObj)
@@ -91,7 +125,7 @@ public:
 
 		bool result = false;
 
-		if (rclsid == cityLotteryOrdinance.GetID())
+		if (rclsid == cityLotteryOrdinance.GetState().id)
 		{
 			result = cityLotteryOrdinance.QueryInterface(riid, ppvObj);
 		}
@@ -109,7 +143,7 @@ public:
 
 			if (pOrdinanceSimulator)
 			{
-				cISC4Ordinance* pOrdinance = pOrdinanceSimulator->GetOrdinanceByID(cityLotteryOrdinance.GetID());
+				cISC4Ordinance* pOrdinance = pOrdinanceSimulator->GetOrdinanceByID(cityLotteryOrdinance.GetState().id);
 				bool ordinanceInitialized = false;
 
 				if (!pOrdinance)
@@ -120,7 +154,7 @@ public:
 					ordinanceInitialized = true;
 
 					pOrdinanceSimulator->AddOrdinance(cityLotteryOrdinance);
-					pOrdinance = pOrdinanceSimulator->GetOrdinanceByID(cityLotteryOrdinance.GetID());
+					pOrdinance = pOrdinanceSimulator->GetOrdinanceByID(cityLotteryOrdinance.GetState().id);
 				}
 
 				if (pOrdinance)
@@ -138,6 +172,16 @@ public:
 				{
 					Logger::GetInstance().WriteLine(LogOptions::Errors, "Failed to add the ordinance.");
 				}
+
+				if constexpr (IsLogCategoryCompiled<LogOptions::DumpRegisteredOrdinances>())
+				{
+					Logger& logger = Logger::GetInstance();
+
+					if (logger.IsEnabled(LogOptions::DumpRegisteredOrdinances))
+					{
+						logger.WriteBlock(LogOptions::DumpRegisteredOrdinances, RegisteredOrdinanceDump::Format(*pOrdinanceSimulator, cityLotteryOrdinance));
+					}
+				}
 			}
 		}
 	}
@@ -156,6 +200,21 @@ public:
 				pOrdinanceSimulator->RemoveOrdinance(cityLotteryOrdinance);
 			}
 		}
+
+		Logger& logger = Logger::GetInstance();
+
+		// The entry point call counts are written once per city session.
+		EntryPointStatistics& statistics = EntryPointStatistics::GetInstance();
+
+		for (const std::string& line : statistics.FormatSummary())
+		{
+			logger.WriteLine(LogOptions::EntryPointStatistics, line.c_str());
+		}
+
+		statistics.Reset();
+
+		logger.Flush();
+		TraceEventRecorder::GetInstance().Flush();
 	}
 
 	bool DoMessage(cIGZMessage2* pMessage)
@@ -215,6 +274,16 @@ public:
 		return true;
 	}
 
+	bool PostAppShutdown()
+	{
+		// The logger's background thread must be stopped before the DLL is unloaded,
+		// it cannot be safely joined from the static destructors.
+		Logger::GetInstance().Shutdown();
+		TraceEventRecorder::GetInstance().Close();
+
+		return true;
+	}
+
 	bool OnStart(cIGZCOM* pCOM)
 	{
 		cIGZFrameWork* const pFramework = RZGetFrameWork();
@@ -231,15 +300,6 @@ public:
 	}
 
 private:
-	std::filesystem::path GetDllFolderPath()
-	{
-		wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(wil::GetModuleInstanceHandle());
-
-		std::filesystem::path temp(modulePath.get());
-
-		return temp.parent_path();
-	}
-
 	std::filesystem::path configFilePath;
 	CityLotteryOrdinance cityLotteryOrdinance;
 	Settings settings;
@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "EntryPointStatistics.h"
+#include <bit>
+#include <cstdarg>
+#include <cstdio>
+#include <iterator>
+
+namespace
+{
+	constexpr const char* EntryPointNames[] =
+	{
+		"cISC4Ordinance::QueryInterface",
+		"cISC4Ordinance::AddRef",
+		"cISC4Ordinance::Release",
+		"cISC4Ordinance::Init",
+		"cISC4Ordinance::Shutdown",
+		"cISC4Ordinance::GetCurrentMonthlyIncome",
+		"cISC4Ordinance::GetID",
+		"cISC4Ordinance::GetName",
+		"cISC4Ordinance::GetDescription",
+		"cISC4Ordinance::GetYearFirstAvailable",
+		"cISC4Ordinance::GetChanceAvailability",
+		"cISC4Ordinance::GetEnactmentIncome",
+		"cISC4Ordinance::GetRetracmentIncome",
+		"cISC4Ordinance::GetMonthlyConstantIncome",
+		"cISC4Ordinance::GetMonthlyIncomeFactor",
+		"cISC4Ordinance::GetMiscProperties",
+		"cISC4Ordinance::GetAdvisorID",
+		"cISC4Ordinance::IsAvailable",
+		"cISC4Ordinance::IsOn",
+		"cISC4Ordinance::IsEnabled",
+		"cISC4Ordinance::GetMonthlyAdjustedIncome",
+		"cISC4Ordinance::CheckConditions",
+		"cISC4Ordinance::IsIncomeOrdinance",
+		"cISC4Ordinance::Simulate",
+		"cISC4Ordinance::SetAvailable",
+		"cISC4Ordinance::SetOn",
+		"cISC4Ordinance::SetEnabled",
+		"cISC4Ordinance::ForceAvailable",
+		"cISC4Ordinance::ForceOn",
+		"cISC4Ordinance::ForceEnabled",
+		"cISC4Ordinance::ForceMonthlyAdjustedIncome",
+		"OrdinanceBase::PostCityInit",
+		"OrdinanceBase::PreCityShutdown",
+		"cISC4Ordinance::Write",
+		"cISC4Ordinance::Read",
+		"cISC4Ordinance::GetGZCLSID",
+		"cISCPropertyHolder::QueryInterface",
+		"cISCPropertyHolder::AddRef",
+		"cISCPropertyHolder::Release",
+		"cISCPropertyHolder::HasProperty",
+		"cISCPropertyHolder::GetPropertyList",
+		"cISCPropertyHolder::GetProperty",
+		"cISCPropertyHolder::GetProperty(uint32_t&)",
+		"cISCPropertyHolder::GetProperty(cIGZString&)",
+		"cISCPropertyHolder::GetProperty(riid)",
+		"cISCPropertyHolder::GetProperty(void*)",
+		"cISCPropertyHolder::AddProperty",
+		"cISCPropertyHolder::AddProperty(cIGZVariant)",
+		"cISCPropertyHolder::AddProperty(uint32_t)",
+		"cISCPropertyHolder::AddProperty(cIGZString)",
+		"cISCPropertyHolder::AddProperty(int32_t)",
+		"cISCPropertyHolder::AddProperty(void*)",
+		"cISCPropertyHolder::CopyAddProperty",
+		"cISCPropertyHolder::RemoveProperty",
+		"cISCPropertyHolder::RemoveAllProperties",
+		"cISCPropertyHolder::EnumProperties",
+		"cISCPropertyHolder::EnumProperties(pipe)",
+		"cISCPropertyHolder::CompactProperties",
+		"cISCPropertyHolder::Write",
+		"cISCPropertyHolder::Read",
+		"cISCPropertyHolder::GetGZCLSID",
+	};
+
+	static_assert(std::size(EntryPointNames) == EntryPointStatistics::EntryPointCount);
+
+#ifdef SC4_HAVE_RDTSC
+	constexpr const char* LatencyUnit = "cycles";
+#else
+	constexpr const char* LatencyUnit = "ns";
+#endif
+
+	std::string Format(const char* format, ...)
+	{
+		char buffer[256]{};
+
+		va_list args;
+		va_start(args, format);
+
+		std::vsnprintf(buffer, sizeof(buffer), format, args);
+
+		va_end(args);
+
+		return std::string(buffer);
+	}
+}
+
+size_t EntryPointStatistics::GetBucketIndex(uint64_t cycles)
+{
+	if (cycles < LinearBucketCount)
+	{
+		return static_cast<size_t>(cycles);
+	}
+
+	const uint32_t exponent = static_cast<uint32_t>(63 - std::countl_zero(cycles));
+
+	if (exponent > MaxExponent)
+	{
+		return BucketCount - 1;
+	}
+
+	const size_t subBucket = static_cast<size_t>(cycles >> (exponent - SubBucketBits)) & ((1 << SubBucketBits) - 1);
+
+	return LinearBucketCount + ((static_cast<size_t>(exponent) - 4) << SubBucketBits) + subBucket;
+}
+
+uint64_t EntryPointStatistics::GetBucketLowerBound(size_t bucket)
+{
+	if (bucket < LinearBucketCount)
+	{
+		return bucket;
+	}
+
+	const size_t offset = bucket - LinearBucketCount;
+	const uint32_t exponent = static_cast<uint32_t>(offset >> SubBucketBits) + 4;
+	const uint64_t subBucket = offset & ((1 << SubBucketBits) - 1);
+
+	return ((uint64_t(1) << SubBucketBits) + subBucket) << (exponent - SubBucketBits);
+}
+
+void EntryPointStatistics::SetLatencyHistogramsEnabled(bool enabled)
+{
+	latencyHistogramsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void EntryPointStatistics::RecordLatency(EntryPoint entryPoint, uint64_t cycles)
+{
+	const size_t index = static_cast<size_t>(entryPoint);
+
+	Increment(totalCycles[index], cycles);
+	Increment(histograms[index][GetBucketIndex(cycles)], 1);
+
+	uint64_t currentMaxCycles = maxCycles[index].load(std::memory_order_relaxed);
+
+	// On failure compare_exchange_weak reloads the current maximum, the loop ends when
+	// another thread has stored a larger value.
+	while (cycles > currentMaxCycles
+		&& !maxCycles[index].compare_exchange_weak(currentMaxCycles, cycles, std::memory_order_relaxed))
+	{
+	}
+}
+
+uint64_t EntryPointStatistics::GetCallCount(EntryPoint entryPoint) const
+{
+	return callCounts[static_cast<size_t>(entryPoint)].load(std::memory_order_relaxed);
+}
+
+std::vector<std::string> EntryPointStatistics::FormatSummary() const
+{
+	std::vector<std::string> lines;
+
+	const uint64_t monthCount = GetCallCount(EntryPoint::OrdinanceSimulate);
+	const bool includeLatency = LatencyHistogramsEnabled();
+
+	lines.push_back(Format("Entry point statistics, %llu simulated months:", static_cast<unsigned long long>(monthCount)));
+
+	if (includeLatency)
+	{
+		lines.push_back(Format(
+			"%-46s %12s %10s %10s %10s %10s %10s (%s)",
+			"Entry point",
+			"Calls",
+			"Per month",
+			"Mean",
+			"p50",
+			"p99",
+			"Max",
+			LatencyUnit));
+	}
+	else
+	{
+		lines.push_back(Format("%-46s %12s %10s", "Entry point", "Calls", "Per month"));
+	}
+
+	for (size_t i = 0; i < EntryPointCount; i++)
+	{
+		const uint64_t calls = callCounts[i].load(std::memory_order_relaxed);
+
+		if (calls == 0)
+		{
+			continue;
+		}
+
+		const double callsPerMonth = monthCount > 0 ? static_cast<double>(calls) / static_cast<double>(monthCount) : 0.0;
+
+		if (!includeLatency)
+		{
+			lines.push_back(Format("%-46s %12llu %10.2f", EntryPointNames[i], static_cast<unsigned long long>(calls), callsPerMonth));
+			continue;
+		}
+
+		// The calls that were made before the histograms were enabled are not included.
+		uint64_t sampleCount = 0;
+
+		for (const std::atomic<uint64_t>& bucket : histograms[i])
+		{
+			sampleCount += bucket.load(std::memory_order_relaxed);
+		}
+
+		uint64_t p50 = 0;
+		uint64_t p99 = 0;
+		uint64_t cumulativeCount = 0;
+		bool foundP50 = false;
+		bool foundP99 = false;
+
+		for (size_t bucket = 0; bucket < BucketCount && !foundP99; bucket++)
+		{
+			cumulativeCount += histograms[i][bucket].load(std::memory_order_relaxed);
+
+			if (!foundP50 && cumulativeCount * 2 >= sampleCount)
+			{
+				p50 = GetBucketLowerBound(bucket);
+				foundP50 = true;
+			}
+
+			if (cumulativeCount * 100 >= sampleCount * 99)
+			{
+				p99 = GetBucketLowerBound(bucket);
+				foundP99 = true;
+			}
+		}
+
+		const uint64_t mean = sampleCount > 0 ? totalCycles[i].load(std::memory_order_relaxed) / sampleCount : 0;
+
+		lines.push_back(Format(
+			"%-46s %12llu %10.2f %10llu %10llu %10llu %10llu",
+			EntryPointNames[i],
+			static_cast<unsigned long long>(calls),
+			callsPerMonth,
+			static_cast<unsigned long long>(mean),
+			static_cast<unsigned long long>(p50),
+			static_cast<unsigned long long>(p99),
+			static_cast<unsigned long long>(maxCycles[i].load(std::memory_order_relaxed))));
+	}
+
+	return lines;
+}
+
+void EntryPointStatistics::Reset()
+{
+	for (size_t i = 0; i < EntryPointCount; i++)
+	{
+		callCounts[i].store(0, std::memory_order_relaxed);
+		totalCycles[i].store(0, std::memory_order_relaxed);
+		maxCycles[i].store(0, std::memory_order_relaxed);
+
+		for (std::atomic<uint64_t>& bucket : histograms[i])
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define SC4_HAVE_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>
+#define SC4_HAVE_RDTSC 1
+#endif
+
+// The cISC4Ordinance and cISCPropertyHolder methods that the game calls.
+enum class EntryPoint : uint32_t
+{
+	OrdinanceQueryInterface,
+	OrdinanceAddRef,
+	OrdinanceRelease,
+	OrdinanceInit,
+	OrdinanceShutdown,
+	OrdinanceGetCurrentMonthlyIncome,
+	OrdinanceGetID,
+	OrdinanceGetName,
+	OrdinanceGetDescription,
+	OrdinanceGetYearFirstAvailable,
+	OrdinanceGetChanceAvailability,
+	OrdinanceGetEnactmentIncome,
+	OrdinanceGetRetracmentIncome,
+	OrdinanceGetMonthlyConstantIncome,
+	OrdinanceGetMonthlyIncomeFactor,
+	OrdinanceGetMiscProperties,
+	OrdinanceGetAdvisorID,
+	OrdinanceIsAvailable,
+	OrdinanceIsOn,
+	OrdinanceIsEnabled,
+	OrdinanceGetMonthlyAdjustedIncome,
+	OrdinanceCheckConditions,
+	OrdinanceIsIncomeOrdinance,
+	OrdinanceSimulate,
+	OrdinanceSetAvailable,
+	OrdinanceSetOn,
+	OrdinanceSetEnabled,
+	OrdinanceForceAvailable,
+	OrdinanceForceOn,
+	OrdinanceForceEnabled,
+	OrdinanceForceMonthlyAdjustedIncome,
+	OrdinancePostCityInit,
+	OrdinancePreCityShutdown,
+	OrdinanceWrite,
+	OrdinanceRead,
+	OrdinanceGetGZCLSID,
+	PropertyHolderQueryInterface,
+	PropertyHolderAddRef,
+	PropertyHolderRelease,
+	PropertyHolderHasProperty,
+	PropertyHolderGetPropertyList,
+	PropertyHolderGetProperty,
+	PropertyHolderGetPropertyUint32,
+	PropertyHolderGetPropertyString,
+	PropertyHolderGetPropertyInterface,
+	PropertyHolderGetPropertyVoid,
+	PropertyHolderAddProperty,
+	PropertyHolderAddPropertyVariant,
+	PropertyHolderAddPropertyUint32,
+	PropertyHolderAddPropertyString,
+	PropertyHolderAddPropertySint32,
+	PropertyHolderAddPropertyVoid,
+	PropertyHolderCopyAddProperty,
+	PropertyHolderRemoveProperty,
+	PropertyHolderRemoveAllProperties,
+	PropertyHolderEnumProperties,
+	PropertyHolderEnumPropertiesPipe,
+	PropertyHolderCompactProperties,
+	PropertyHolderWrite,
+	PropertyHolderRead,
+	PropertyHolderGetGZCLSID,
+	Count
+};
+
+// Call counters for each entry point, with optional latency histograms.
+//
+// The call counters are always enabled. Each counter is incremented with a relaxed
+// fetch_add, so calls that overlap on different threads are all counted.
+// When the latency histograms are enabled the duration of each call is measured
+// with the CPU cycle counter (or in nanoseconds on platforms without one), and
+// recorded in log-linear buckets: exact values below 16, and 4 buckets for each
+// power of two above that.
+class EntryPointStatistics
+{
+public:
+
+	static constexpr size_t EntryPointCount = static_cast<size_t>(EntryPoint::Count);
+	static constexpr size_t LinearBucketCount = 16;
+	static constexpr size_t SubBucketBits = 2;
+	static constexpr uint32_t MaxExponent = 40;
+	static constexpr size_t BucketCount = LinearBucketCount + ((MaxExponent - 3) << SubBucketBits);
+
+	static EntryPointStatistics& GetInstance()
+	{
+		// The class is constant-initialized, so this does not need a thread-safe initialization guard.
+		static EntryPointStatistics instance;
+
+		return instance;
+	}
+
+	static uint64_t ReadCycleCounter()
+	{
+#ifdef SC4_HAVE_RDTSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	/**
+	 * @brief Gets the bucket that a duration is recorded in.
+	 * @param cycles The duration.
+	 * @return The bucket index.
+	*/
+	static size_t GetBucketIndex(uint64_t cycles);
+
+	/**
+	 * @brief Gets the smallest duration that is recorded in a bucket.
+	 * @param bucket The bucket index.
+	 * @return The smallest duration in the bucket.
+	*/
+	static uint64_t GetBucketLowerBound(size_t bucket);
+
+	bool LatencyHistogramsEnabled() const
+	{
+		return latencyHistogramsEnabled.load(std::memory_order_relaxed);
+	}
+
+	void SetLatencyHistogramsEnabled(bool enabled);
+
+	void RecordCall(EntryPoint entryPoint)
+	{
+		Increment(callCounts[static_cast<size_t>(entryPoint)], 1);
+	}
+
+	void RecordLatency(EntryPoint entryPoint, uint64_t cycles);
+
+	uint64_t GetCallCount(EntryPoint entryPoint) const;
+
+	/**
+	 * @brief Formats a table of the entry points that were called.
+	 * The number of calls per month is based on the number of Simulate calls.
+	 * @return The table lines.
+	*/
+	std::vector<std::string> FormatSummary() const;
+
+	/**
+	 * @brief Resets the counters and histograms.
+	*/
+	void Reset();
+
+private:
+
+	constexpr EntryPointStatistics() = default;
+
+	static void Increment(std::atomic<uint64_t>& counter, uint64_t value)
+	{
+		counter.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	std::atomic<bool> latencyHistogramsEnabled{ false };
+	std::array<std::atomic<uint64_t>, EntryPointCount> callCounts{};
+	std::array<std::atomic<uint64_t>, EntryPointCount> totalCycles{};
+	std::array<std::atomic<uint64_t>, EntryPointCount> maxCycles{};
+	std::array<std::array<std::atomic<uint64_t>, BucketCount>, EntryPointCount> histograms{};
+};
+
+// Records a call to an entry point, and its duration when the latency histograms are enabled.
+class EntryPointScope
+{
+public:
+
+	explicit EntryPointScope(EntryPoint entryPoint)
+		: entryPoint(entryPoint), start(0)
+	{
+		EntryPointStatistics& statistics = EntryPointStatistics::GetInstance();
+
+		statistics.RecordCall(entryPoint);
+
+		if (statistics.LatencyHistogramsEnabled())
+		{
+			start = EntryPointStatistics::ReadCycleCounter();
+		}
+	}
+
+	~EntryPointScope()
+	{
+		if (start != 0)
+		{
+			EntryPointStatistics::GetInstance().RecordLatency(
+				entryPoint,
+				EntryPointStatistics::ReadCycleCounter() - start);
+		}
+	}
+
+	EntryPointScope(const EntryPointScope&) = delete;
+	EntryPointScope& operator=(const EntryPointScope&) = delete;
+
+private:
+
+	EntryPoint entryPoint;
+	uint64_t start;
+};
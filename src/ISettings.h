@@ -13,6 +13,8 @@
 #pragma once
 #include "stdint.h"
 #include "OrdinancePropertyHolder.h"
+#include "PopulationIncomeFactor.h"
+#include <vector>
 
 class ISettings
 {
@@ -20,11 +22,17 @@ public:
 
 	virtual int64_t MonthlyConstantIncome() const = 0;
 
-	virtual float ResidentialLowWealthFactor() const = 0;
-
-	virtual float ResidentialMedWealthFactor() const = 0;
-
-	virtual float ResidentialHighWealthFactor() const = 0;
+	/**
+	 * @brief Gets the census groups that contribute to the monthly income.
+	 * @return The census groups that contribute to the monthly income, groups
+	 * with a factor of zero are not included.
+	*/
+	virtual const std::vector<PopulationIncomeFactor>& PopulationIncomeFactors() const = 0;
 
+	/**
+	 * @brief Gets the ordinance effects.
+	 * @return A copy of the effects that shares the property set owned by the settings,
+	 * the set is only copied if the returned holder is modified.
+	*/
 	virtual OrdinancePropertyHolder OrdinanceEffects() const = 0;
 };
\ No newline at end of file
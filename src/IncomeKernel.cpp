@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "IncomeKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	constexpr uint64_t FractionScale = uint64_t(1) << 32;
+	constexpr uint64_t FractionMask = FractionScale - 1;
+
+	int64_t SaturatingAdd(int64_t lhs, int64_t rhs)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		int64_t result = 0;
+
+		if (__builtin_add_overflow(lhs, rhs, &result))
+		{
+			result = rhs > 0 ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+		}
+
+		return result;
+#else
+		if (rhs > 0 && lhs > std::numeric_limits<int64_t>::max() - rhs)
+		{
+			return std::numeric_limits<int64_t>::max();
+		}
+		else if (rhs < 0 && lhs < std::numeric_limits<int64_t>::min() - rhs)
+		{
+			return std::numeric_limits<int64_t>::min();
+		}
+
+		return lhs + rhs;
+#endif
+	}
+
+	// Returns true if the addition overflowed.
+	bool AddOverflow(uint64_t lhs, uint64_t rhs, uint64_t& result)
+	{
+		result = lhs + rhs;
+		return result < lhs;
+	}
+
+	// A 32 x 32-bit multiply with a 64-bit result. MSVC on x86 may call its 64 x 64-bit
+	// multiply helper for the equivalent C++ expression.
+	uint64_t Multiply32(uint32_t lhs, uint32_t rhs)
+	{
+#if defined(_MSC_VER) && defined(_M_IX86)
+		return __emulu(lhs, rhs);
+#else
+		return static_cast<uint64_t>(lhs) * rhs;
+#endif
+	}
+
+	// Returns true if the multiplication overflowed, the result is only valid if it did not.
+	bool MultiplyOverflow(uint64_t lhs, uint64_t rhs, uint64_t& result)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_mul_overflow(lhs, rhs, &result);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		uint64_t high = 0;
+		result = _umul128(lhs, rhs, &high);
+
+		return high != 0;
+#else
+		// The operands are split into 32-bit halves, so that no 64-bit multiply or divide
+		// helper is called on 32-bit platforms.
+		const uint32_t lhsHigh = static_cast<uint32_t>(lhs >> 32);
+		const uint32_t rhsHigh = static_cast<uint32_t>(rhs >> 32);
+
+		result = Multiply32(static_cast<uint32_t>(lhs), static_cast<uint32_t>(rhs));
+
+		if (lhsHigh == 0 && rhsHigh == 0)
+		{
+			return false;
+		}
+		else if (lhsHigh != 0 && rhsHigh != 0)
+		{
+			return true;
+		}
+
+		// Only one operand has a high half, so the cross product is a single 32 x 32-bit
+		// multiply that must fit in the high half of the result.
+		const uint64_t crossProduct = lhsHigh != 0
+			? Multiply32(lhsHigh, static_cast<uint32_t>(rhs))
+			: Multiply32(static_cast<uint32_t>(lhs), rhsHigh);
+
+		if ((crossProduct >> 32) != 0)
+		{
+			return true;
+		}
+
+		return AddOverflow(result, crossProduct << 32, result);
+#endif
+	}
+
+	uint64_t PopulationToInteger(float population)
+	{
+		// The comparison is false for NaN.
+		if (!(population > 0.0f))
+		{
+			return 0;
+		}
+		else if (population >= 9223372036854775808.0f)
+		{
+			return std::numeric_limits<uint64_t>::max();
+		}
+
+		// The signed conversion is a single instruction on x86, the unsigned one is not.
+		return static_cast<uint64_t>(static_cast<int64_t>(population));
+	}
+}
+
+IncomeKernel::FixedPointFactor IncomeKernel::ToFixedPoint(float factor)
+{
+	FixedPointFactor result{};
+
+	if (!(factor > 0.0f))
+	{
+		return result;
+	}
+	else if (factor >= 9223372036854775808.0f)
+	{
+		result.whole = std::numeric_limits<int64_t>::max();
+		return result;
+	}
+
+	const double wholePart = std::floor(static_cast<double>(factor));
+	const double fractionPart = static_cast<double>(factor) - wholePart;
+
+	result.whole = static_cast<int64_t>(wholePart);
+
+	const uint64_t fraction = static_cast<uint64_t>(std::llround(fractionPart * static_cast<double>(FractionScale)));
+
+	if (fraction >= FractionScale)
+	{
+		result.whole = SaturatingAdd(result.whole, int64_t(1));
+	}
+	else
+	{
+		result.fraction = static_cast<uint32_t>(fraction);
+	}
+
+	return result;
+}
+
+int64_t IncomeKernel::CalculateFixedPoint(
+	int64_t constantIncome,
+	const float* populations,
+	const FixedPointFactor* factors,
+	size_t count)
+{
+	// The population income is non-negative, it is accumulated as a whole
+	// number and a 32-bit fraction so that no precision is lost.
+	// Overflow is tracked with a flag instead of saturating every step.
+	uint64_t wholeIncome = 0;
+	uint64_t fractionIncome = 0;
+	bool overflow = false;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const float populationValue = populations[i];
+		const FixedPointFactor& factor = factors[i];
+
+		// The comparisons are false for NaN.
+		if (populationValue >= 0.0f
+			&& populationValue < 2147483648.0f
+			&& (static_cast<uint64_t>(factor.whole) >> 32) == 0)
+		{
+			// The population and the whole part of the factor fit in 32 bits, which is
+			// the common case. The population conversion is a single instruction on both
+			// x86 and x64, both products are single 32 x 32-bit multiplies, and their sum
+			// is less than 2^64.
+			const uint32_t population = static_cast<uint32_t>(static_cast<int32_t>(populationValue));
+			const uint64_t product = Multiply32(population, static_cast<uint32_t>(factor.whole));
+			const uint64_t low = Multiply32(population, factor.fraction);
+
+			overflow |= AddOverflow(wholeIncome, product + (low >> 32), wholeIncome);
+			fractionIncome += low & FractionMask;
+			continue;
+		}
+
+		const uint64_t population = PopulationToInteger(populationValue);
+
+		uint64_t product = 0;
+		overflow |= MultiplyOverflow(population, static_cast<uint64_t>(factor.whole), product);
+		overflow |= AddOverflow(wholeIncome, product, wholeIncome);
+
+		// A 64 x 32-bit multiply, split into two 32 x 32-bit products that cannot overflow.
+		// The sum of the high product and the whole part of the low product is also less than 2^64.
+		const uint64_t low = Multiply32(static_cast<uint32_t>(population), factor.fraction);
+		const uint64_t high = Multiply32(static_cast<uint32_t>(population >> 32), factor.fraction);
+
+		overflow |= AddOverflow(wholeIncome, high + (low >> 32), wholeIncome);
+		fractionIncome += low & FractionMask;
+	}
+
+	overflow |= AddOverflow(wholeIncome, fractionIncome >> 32, wholeIncome);
+	const bool hasFraction = (fractionIncome & FractionMask) != 0;
+
+	if (overflow || wholeIncome > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+	{
+		wholeIncome = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+	}
+
+	int64_t result = SaturatingAdd(constantIncome, static_cast<int64_t>(wholeIncome));
+
+	// The fraction was truncated, which rounds toward negative infinity.
+	// A negative result is adjusted so that it is rounded toward zero.
+	if (hasFraction && result < 0)
+	{
+		result++;
+	}
+
+	return result;
+}
+
+int64_t IncomeKernel::CalculateDouble(
+	int64_t constantIncome,
+	const float* populations,
+	const float* factors,
+	size_t count)
+{
+	double monthlyIncome = static_cast<double>(constantIncome);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const double population = std::max(populations[i], 0.0f);
+
+		monthlyIncome += population * static_cast<double>(factors[i]);
+	}
+
+	int64_t monthlyIncomeInteger = 0;
+
+	if (monthlyIncome < std::numeric_limits<int64_t>::min())
+	{
+		monthlyIncomeInteger = std::numeric_limits<int64_t>::min();
+	}
+	else if (monthlyIncome >= static_cast<double>(std::numeric_limits<int64_t>::max()))
+	{
+		monthlyIncomeInteger = std::numeric_limits<int64_t>::max();
+	}
+	else
+	{
+		monthlyIncomeInteger = static_cast<int64_t>(monthlyIncome);
+	}
+
+	return monthlyIncomeInteger;
+}
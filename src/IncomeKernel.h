@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// The arithmetic used to calculate the population-based monthly income.
+//
+// The income is calculated with fixed-point integer math: each factor is split
+// into a whole number and a 32-bit binary fraction, and the populations are
+// multiplied and accumulated with saturating 64-bit arithmetic. Unlike the
+// double-precision calculation the result does not lose precision for large
+// populations, and the int64_t limits are handled exactly.
+// The populations are truncated to whole numbers before they are multiplied, so
+// the result is only exact for whole-number populations. A census group with a
+// fractional population can add up to its income factor less than the
+// double-precision calculation.
+namespace IncomeKernel
+{
+	struct FixedPointFactor
+	{
+		int64_t whole;
+		uint32_t fraction;
+	};
+
+	/**
+	 * @brief Converts an income factor to fixed-point.
+	 * @param factor The income factor. Values of 0.0 or less and NaN are converted to zero.
+	 * @return The fixed-point factor, rounded to the nearest 1/2^32.
+	*/
+	FixedPointFactor ToFixedPoint(float factor);
+
+	/**
+	 * @brief Calculates the monthly income using fixed-point math.
+	 * @param constantIncome The monthly constant income.
+	 * @param populations The population of each census group, negative populations are treated as zero
+	 * and fractional populations are truncated.
+	 * @param factors The fixed-point income factor of each census group.
+	 * @param count The number of census groups.
+	 * @return The monthly income, rounded toward zero and saturated to the range of int64_t.
+	*/
+	int64_t CalculateFixedPoint(
+		int64_t constantIncome,
+		const float* populations,
+		const FixedPointFactor* factors,
+		size_t count);
+
+	/**
+	 * @brief Calculates the monthly income using double-precision floating point math.
+	 * This is the original income calculation, it is kept as a reference for the fixed-point version.
+	 * @param constantIncome The monthly constant income.
+	 * @param populations The population of each census group, negative populations are treated as zero.
+	 * @param factors The income factor of each census group.
+	 * @param count The number of census groups.
+	 * @return The monthly income, rounded toward zero and clamped to the range of int64_t.
+	*/
+	int64_t CalculateDouble(
+		int64_t constantIncome,
+		const float* populations,
+		const float* factors,
+		size_t count);
+}
@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "LogRateLimiter.h"
+#include "Logger.h"
+#include <bit>
+#include <cstdio>
+
+namespace
+{
+	constexpr const char* CategoryNames[] =
+	{
+		"Errors",
+		"OrdinanceAPI",
+		"OrdinancePropertyAPI",
+		"DumpRegisteredOrdinances",
+		"EntryPointStatistics",
+	};
+
+	size_t GetCategoryIndex(LogOptions category)
+	{
+		const uint32_t value = static_cast<uint32_t>(category);
+
+		return value != 0 ? static_cast<size_t>(std::countr_zero(value)) : 0;
+	}
+
+	uint64_t HashMessage(const char* message, size_t length)
+	{
+		// 64-bit FNV-1a.
+		uint64_t hash = 0xcbf29ce484222325;
+
+		for (size_t i = 0; i < length; i++)
+		{
+			hash ^= static_cast<uint8_t>(message[i]);
+			hash *= 0x100000001b3;
+		}
+
+		return hash;
+	}
+
+	void AppendFormatted(std::vector<std::string>& lines, const char* format, const char* text, uint32_t count, uint32_t simMonth)
+	{
+		char buffer[512]{};
+
+		std::snprintf(buffer, sizeof(buffer), format, text, count, simMonth);
+
+		lines.emplace_back(buffer);
+	}
+}
+
+LogRateLimiter::LogRateLimiter()
+	: deduplicationEnabled(false),
+	  limitsEnabled(false),
+	  simMonth(0),
+	  messages(),
+	  messageIndices(),
+	  categories()
+{
+	static_assert(std::size(CategoryNames) == CategoryCount);
+}
+
+bool LogRateLimiter::IsActive() const
+{
+	return deduplicationEnabled || limitsEnabled;
+}
+
+bool LogRateLimiter::IsDeduplicationEnabled() const
+{
+	return deduplicationEnabled;
+}
+
+void LogRateLimiter::SetDeduplicationEnabled(bool enabled)
+{
+	deduplicationEnabled = enabled;
+}
+
+void LogRateLimiter::SetMonthlyLineLimit(LogOptions category, uint32_t maxLines)
+{
+	const size_t index = GetCategoryIndex(category);
+
+	if (index < CategoryCount)
+	{
+		categories[index].monthlyLineLimit = maxLines;
+	}
+
+	limitsEnabled = false;
+
+	for (const CategoryState& state : categories)
+	{
+		if (state.monthlyLineLimit > 0)
+		{
+			limitsEnabled = true;
+			break;
+		}
+	}
+}
+
+bool LogRateLimiter::ShouldWrite(LogOptions category, const char* message, size_t length)
+{
+	const bool deduplicate = deduplicationEnabled && message;
+	uint64_t hash = 0;
+	bool trackMessage = false;
+
+	if (deduplicate)
+	{
+		hash = HashMessage(message, length);
+
+		auto it = messageIndices.find(hash);
+
+		if (it != messageIndices.end())
+		{
+			RepeatedMessage& repeatedMessage = messages[it->second];
+
+			// A different message with the same hash is written without being tracked.
+			if (repeatedMessage.message.compare(0, std::string::npos, message, length) == 0)
+			{
+				repeatedMessage.repeatCount++;
+				return false;
+			}
+		}
+		else
+		{
+			trackMessage = true;
+		}
+	}
+
+	if (limitsEnabled)
+	{
+		const size_t index = GetCategoryIndex(category);
+
+		if (index < CategoryCount)
+		{
+			CategoryState& state = categories[index];
+
+			if (state.monthlyLineLimit > 0 && state.lineCount >= state.monthlyLineLimit)
+			{
+				state.suppressedLineCount++;
+				return false;
+			}
+
+			state.lineCount++;
+		}
+	}
+
+	// Only the messages that were written are tracked, so that each repeat
+	// summary follows the line it refers to.
+	if (trackMessage)
+	{
+		messageIndices.emplace(hash, messages.size());
+		messages.push_back(RepeatedMessage{ std::string(message, length), 0 });
+	}
+
+	return true;
+}
+
+void LogRateLimiter::SetSimMonth(uint32_t simMonth, std::vector<std::string>& summaries)
+{
+	if (this->simMonth != simMonth)
+	{
+		EndPeriod(summaries);
+		this->simMonth = simMonth;
+	}
+}
+
+void LogRateLimiter::EndPeriod(std::vector<std::string>& summaries)
+{
+	for (const RepeatedMessage& item : messages)
+	{
+		if (item.repeatCount > 0)
+		{
+			AppendFormatted(
+				summaries,
+				"%s (repeated %u times in sim month %u)",
+				item.message.c_str(),
+				item.repeatCount,
+				simMonth);
+		}
+	}
+
+	messages.clear();
+	messageIndices.clear();
+
+	for (size_t i = 0; i < CategoryCount; i++)
+	{
+		CategoryState& state = categories[i];
+
+		if (state.suppressedLineCount > 0)
+		{
+			AppendFormatted(
+				summaries,
+				"%s: %u log lines were suppressed in sim month %u",
+				CategoryNames[i],
+				state.suppressedLineCount,
+				simMonth);
+		}
+
+		state.lineCount = 0;
+		state.suppressedLineCount = 0;
+	}
+}
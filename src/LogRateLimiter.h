@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class LogOptions : int32_t;
+
+// Collapses repeated log lines and limits the number of lines that each log
+// category writes per simulation month.
+//
+// Within a sim month only the first occurrence of each distinct message is
+// written, the repeats are counted. When the month ends, a "(repeated N times)"
+// summary is written for each repeated message, along with the number of lines
+// that were suppressed by the category limits.
+class LogRateLimiter
+{
+public:
+
+	LogRateLimiter();
+
+	/**
+	 * @brief Determines if any of the deduplication or rate limits are enabled.
+	 * @return True if the limiter is active; otherwise, false.
+	*/
+	bool IsActive() const;
+
+	bool IsDeduplicationEnabled() const;
+
+	void SetDeduplicationEnabled(bool enabled);
+
+	/**
+	 * @brief Sets the maximum number of lines that a log category can write per sim month.
+	 * @param category The log category.
+	 * @param maxLines The maximum number of lines, 0 removes the limit.
+	*/
+	void SetMonthlyLineLimit(LogOptions category, uint32_t maxLines);
+
+	/**
+	 * @brief Determines if the message should be written, and records it.
+	 * @param category The log category of the message.
+	 * @param message The formatted message, or nullptr if the message should not be deduplicated.
+	 * @param length The message length.
+	 * @return True if the message should be written; otherwise, false.
+	*/
+	bool ShouldWrite(LogOptions category, const char* message, size_t length);
+
+	/**
+	 * @brief Starts a new sim month if the month has changed.
+	 * @param simMonth The sim month.
+	 * @param summaries Receives the summaries of the previous month.
+	*/
+	void SetSimMonth(uint32_t simMonth, std::vector<std::string>& summaries);
+
+	/**
+	 * @brief Ends the current counting period and starts a new one in the same sim month.
+	 * @param summaries Receives the summaries of the repeated and suppressed lines.
+	*/
+	void EndPeriod(std::vector<std::string>& summaries);
+
+private:
+
+	static constexpr size_t CategoryCount = 5;
+
+	struct RepeatedMessage
+	{
+		std::string message;
+		uint32_t repeatCount;
+	};
+
+	struct CategoryState
+	{
+		uint32_t monthlyLineLimit;
+		uint32_t lineCount;
+		uint32_t suppressedLineCount;
+	};
+
+	bool deduplicationEnabled;
+	bool limitsEnabled;
+	uint32_t simMonth;
+	// The distinct messages of the current month, in the order they were first written.
+	std::vector<RepeatedMessage> messages;
+	std::unordered_map<uint64_t, size_t> messageIndices;
+	std::array<CategoryState, CategoryCount> categories;
+};
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "LogRingBuffer.h"
+
+LogRingBuffer::LogRingBuffer(size_t capacity)
+	: records(std::make_unique<Record[]>(capacity)),
+	  mask(capacity - 1),
+	  writeIndex(0),
+	  cachedReadIndex(0),
+	  readIndex(0),
+	  cachedWriteIndex(0)
+{
+}
+
+LogRingBuffer::Record* LogRingBuffer::BeginWrite()
+{
+	const size_t index = writeIndex.load(std::memory_order_relaxed);
+
+	if ((index - cachedReadIndex) > mask)
+	{
+		cachedReadIndex = readIndex.load(std::memory_order_acquire);
+
+		if ((index - cachedReadIndex) > mask)
+		{
+			return nullptr;
+		}
+	}
+
+	return &records[index & mask];
+}
+
+void LogRingBuffer::EndWrite()
+{
+	writeIndex.store(writeIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+const LogRingBuffer::Record* LogRingBuffer::BeginRead()
+{
+	const size_t index = readIndex.load(std::memory_order_relaxed);
+
+	if (index == cachedWriteIndex)
+	{
+		cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+
+		if (index == cachedWriteIndex)
+		{
+			return nullptr;
+		}
+	}
+
+	return &records[index & mask];
+}
+
+void LogRingBuffer::EndRead()
+{
+	readIndex.store(readIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Platform.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// A lock-free ring buffer of fixed-size log records, with one producer thread
+// and one consumer thread.
+class LogRingBuffer
+{
+public:
+
+	static constexpr size_t MessageCapacity = 244;
+
+	enum RecordFlags : uint16_t
+	{
+		None = 0,
+		// The record is written without a timestamp.
+		NoTimestamp = 1 << 0,
+		// The message did not fit in the record and was truncated.
+		Truncated = 1 << 1,
+	};
+
+	struct Record
+	{
+		Platform::LocalTime time;
+		uint16_t length;
+		uint16_t flags;
+		char message[MessageCapacity];
+	};
+
+	/**
+	 * @brief Constructs an instance of the class.
+	 * @param capacity The number of records in the buffer, this must be a power of two.
+	*/
+	explicit LogRingBuffer(size_t capacity);
+
+	/**
+	 * @brief Gets the next free record, only called by the producer.
+	 * @return The next free record, or nullptr if the buffer is full.
+	*/
+	Record* BeginWrite();
+
+	/**
+	 * @brief Makes the record returned by BeginWrite visible to the consumer.
+	*/
+	void EndWrite();
+
+	/**
+	 * @brief Gets the oldest record, only called by the consumer.
+	 * @return The oldest record, or nullptr if the buffer is empty.
+	*/
+	const Record* BeginRead();
+
+	/**
+	 * @brief Releases the record returned by BeginRead.
+	*/
+	void EndRead();
+
+private:
+
+	std::unique_ptr<Record[]> records;
+	const size_t mask;
+
+	// The producer and consumer indices are kept on separate cache lines.
+	alignas(64) std::atomic<size_t> writeIndex;
+	size_t cachedReadIndex;
+	alignas(64) std::atomic<size_t> readIndex;
+	size_t cachedWriteIndex;
+};
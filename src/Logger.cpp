@@ -11,37 +11,44 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "Logger.h"
-#include <Windows.h>
+#include "Platform.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 
 namespace
 {
-	std::string GetTimeStamp()
-	{
-		char buffer[1024]{};
-
-		SYSTEMTIME time;
+	constexpr size_t RingBufferCapacity = 1024;
+	constexpr size_t MaxWriteBatchSize = 64 * 1024;
+	constexpr std::chrono::milliseconds WriterThreadInterval(100);
 
-		GetLocalTime(&time);
+	// The stack buffer used by the synchronous mode, longer lines are formatted
+	// into a heap buffer.
+	constexpr size_t LineBufferSize = 512;
 
-		std::snprintf(
+	int FormatTimeStamp(char* buffer, size_t bufferSize, const Platform::LocalTime& time)
+	{
+		return std::snprintf(
 			buffer,
-			sizeof(buffer),
+			bufferSize,
 			"[%hu:%hu:%hu.%hu] ",
-			time.wHour,
-			time.wMinute,
-			time.wSecond,
-			time.wMilliseconds);
-
-		return std::string(buffer);
+			time.hour,
+			time.minute,
+			time.second,
+			time.milliseconds);
 	}
 
-#ifdef _DEBUG
-	void PrintLineToDebugOutput(const char* line)
+	void AppendTimeStamp(std::string& output, const Platform::LocalTime& time)
 	{
-		OutputDebugStringA(line);
-		OutputDebugStringA("\n");
+		char buffer[64]{};
+
+		const int length = FormatTimeStamp(buffer, sizeof(buffer), time);
+
+		if (length > 0)
+		{
+			output.append(buffer, static_cast<size_t>(length));
+		}
 	}
-#endif // _DEBUG
 }
 
 Logger& Logger::GetInstance()
@@ -51,23 +58,174 @@ Logger& Logger::GetInstance()
 	return logger;
 }
 
-Logger::Logger() : initialized(false), logFile(), logOptions(LogOptions::Errors)
+Logger::Logger()
+	: initialized(false),
+	  logOptions(LogOptions::Errors),
+	  logFile(),
+	  mappedFile(),
+	  rateLimiter(),
+	  rateLimitSummaries(),
+	  traceWriter(),
+	  ringBuffer(),
+	  writerThread(),
+	  writerMutex(),
+	  writerWakeCondition(),
+	  flushCompleteCondition(),
+	  flushRequestCount(0),
+	  flushCompleteCount(0),
+	  droppedLineCount(0),
+	  reportedDroppedLineCount(0),
+	  queuedLinesSinceWake(0),
+	  writeRequested(false),
+	  stopWriterThread(false),
+	  writeBatch(),
+	  pendingBlock()
 {
 }
 
 Logger::~Logger()
 {
+	// The plugin DLL calls Shutdown when the game exits, the background thread
+	// has already stopped when this runs.
+	Shutdown();
 	initialized = false;
 }
 
-void Logger::Init(std::filesystem::path logFilePath, LogOptions options)
+void Logger::Init(
+	std::filesystem::path logFilePath,
+	LogOptions options,
+	LogWriteMode writeMode,
+	size_t maxFileSize)
 {
 	if (!initialized)
 	{
 		initialized = true;
 
-		logFile.open(logFilePath, std::ofstream::out | std::ofstream::trunc);
+		if (maxFileSize > 0 && writeMode != LogWriteMode::BinaryTrace)
+		{
+			mappedFile.Open(logFilePath, maxFileSize);
+		}
+		else
+		{
+			std::ios_base::openmode openMode = std::ofstream::out | std::ofstream::trunc;
+
+			if (writeMode == LogWriteMode::BinaryTrace)
+			{
+				openMode |= std::ofstream::binary;
+			}
+
+			logFile.open(logFilePath, openMode);
+		}
+
 		logOptions = options;
+
+		if (writeMode == LogWriteMode::BinaryTrace && logFile)
+		{
+			traceWriter = std::make_unique<BinaryTraceWriter>(logFile);
+		}
+		else if (writeMode == LogWriteMode::Asynchronous && IsFileOpen())
+		{
+			ringBuffer = std::make_unique<LogRingBuffer>(RingBufferCapacity);
+			stopWriterThread = false;
+			writerThread = std::thread(&Logger::WriterThreadProc, this);
+		}
+	}
+}
+
+void Logger::Flush()
+{
+	EndRateLimitPeriod();
+
+	if (traceWriter)
+	{
+		traceWriter->Flush();
+	}
+	else if (writerThread.joinable())
+	{
+		std::unique_lock<std::mutex> lock(writerMutex);
+
+		const uint64_t request = ++flushRequestCount;
+		writerWakeCondition.notify_one();
+
+		flushCompleteCondition.wait(lock, [&] { return flushCompleteCount >= request; });
+	}
+	else if (IsFileOpen())
+	{
+		FlushFileBuffer();
+	}
+
+	// The writer thread flushes the memory-mapped file while it serves the flush
+	// request, because it can rotate the file at any time.
+	if (mappedFile.IsOpen() && !writerThread.joinable())
+	{
+		mappedFile.Flush();
+	}
+}
+
+void Logger::Shutdown()
+{
+	EndRateLimitPeriod();
+
+	if (writerThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(writerMutex);
+			stopWriterThread = true;
+		}
+
+		writerWakeCondition.notify_one();
+		writerThread.join();
+
+		// Any lines written after this point use the synchronous mode.
+		WriteQueuedLines();
+		ringBuffer.reset();
+	}
+
+	if (traceWriter)
+	{
+		traceWriter->Flush();
+	}
+	else if (IsFileOpen())
+	{
+		FlushFileBuffer();
+	}
+
+	if (mappedFile.IsOpen())
+	{
+		mappedFile.Flush();
+	}
+}
+
+uint64_t Logger::GetDroppedLineCount() const
+{
+	return droppedLineCount.load(std::memory_order_relaxed);
+}
+
+void Logger::SetDeduplicationEnabled(bool enabled)
+{
+	// The repeat counts are written before the settings change.
+	EndRateLimitPeriod();
+	rateLimiter.SetDeduplicationEnabled(enabled);
+}
+
+void Logger::SetMonthlyLineLimit(LogOptions category, uint32_t maxLines)
+{
+	EndRateLimitPeriod();
+	rateLimiter.SetMonthlyLineLimit(category, maxLines);
+}
+
+void Logger::SetSimMonth(uint32_t simMonth)
+{
+	if (rateLimiter.IsActive())
+	{
+		// The summaries are written before the trace switches to the new month.
+		rateLimiter.SetSimMonth(simMonth, rateLimitSummaries);
+		WriteRateLimitSummaries();
+	}
+
+	if (traceWriter)
+	{
+		traceWriter->SetSimMonth(simMonth);
 	}
 }
 
@@ -78,9 +236,19 @@ bool Logger::IsEnabled(LogOptions option) const
 
 void Logger::WriteLogFileHeader(const char* const text)
 {
-	if (initialized && logFile)
+	if (traceWriter)
 	{
-		logFile << text << std::endl;
+		traceWriter->WriteHeaderLine(text);
+	}
+	else if (ringBuffer)
+	{
+		QueueLine(text, LogRingBuffer::NoTimestamp);
+	}
+	else if (IsFileOpen())
+	{
+		WriteToFile(text, std::strlen(text));
+		WriteToFile("\n", 1);
+		FlushFileBuffer();
 	}
 }
 
@@ -91,7 +259,89 @@ void Logger::WriteLine(LogOptions options, const char* const message)
 		return;
 	}
 
-	WriteLineCore(message);
+	if (rateLimiter.IsActive() && !rateLimiter.ShouldWrite(options, message, std::strlen(message)))
+	{
+		return;
+	}
+
+	WriteLineUnfiltered(message);
+}
+
+void Logger::WriteBlock(LogOptions options, const std::string& text)
+{
+	if ((logOptions & options) == LogOptions::None || text.empty())
+	{
+		return;
+	}
+
+	if (traceWriter)
+	{
+		// The binary trace records each line of the block as a text line.
+		size_t lineStart = 0;
+
+		while (lineStart < text.size())
+		{
+			size_t lineEnd = text.find('\n', lineStart);
+
+			if (lineEnd == std::string::npos)
+			{
+				lineEnd = text.size();
+			}
+
+			const std::string line(text, lineStart, lineEnd - lineStart);
+			traceWriter->WriteLine(line.c_str());
+
+			lineStart = lineEnd + 1;
+		}
+
+		return;
+	}
+
+	std::string block;
+	block.reserve(text.size() + 32);
+
+	AppendTimeStamp(block, Platform::GetLocalTime());
+	block.append(text);
+
+	if (block.back() != '\n')
+	{
+		block.push_back('\n');
+	}
+
+	if (writerThread.joinable())
+	{
+		// The block is too large for the ring buffer, it is handed to the writer thread,
+		// which writes it after the lines that were queued before it.
+		std::unique_lock<std::mutex> lock(writerMutex);
+
+		pendingBlock.swap(block);
+
+		const uint64_t request = ++flushRequestCount;
+		writerWakeCondition.notify_one();
+
+		flushCompleteCondition.wait(lock, [&] { return flushCompleteCount >= request; });
+	}
+	else if (IsFileOpen())
+	{
+		WriteToFile(block.data(), block.size());
+		FlushFileBuffer();
+	}
+}
+
+void Logger::WriteLineUnfiltered(const char* const message)
+{
+	if (traceWriter)
+	{
+		traceWriter->WriteLine(message);
+	}
+	else if (ringBuffer)
+	{
+		QueueLine(message, LogRingBuffer::None);
+	}
+	else
+	{
+		WriteLineCore(message);
+	}
 }
 
 void Logger::WriteLineFormatted(LogOptions options, const char* const format, ...)
@@ -104,35 +354,389 @@ void Logger::WriteLineFormatted(LogOptions options, const char* const format, ..
 	va_list args;
 	va_start(args, format);
 
+	if (rateLimiter.IsActive())
+	{
+		WriteLineFormattedRateLimited(options, format, args);
+	}
+	else
+	{
+		WriteLineFormattedUnfiltered(format, args);
+	}
+
+	va_end(args);
+}
+
+void Logger::WriteLineFormattedUnfiltered(const char* const format, va_list args)
+{
+	if (traceWriter)
+	{
+		traceWriter->WriteLineFormatted(format, args);
+	}
+	else if (ringBuffer)
+	{
+		QueueLineFormatted(format, args);
+	}
+	else
+	{
+		WriteLineFormattedCore(format, args);
+	}
+}
+
+void Logger::WriteLineFormattedRateLimited(LogOptions options, const char* const format, va_list args)
+{
+	if (!rateLimiter.IsDeduplicationEnabled())
+	{
+		if (rateLimiter.ShouldWrite(options, nullptr, 0))
+		{
+			WriteLineFormattedUnfiltered(format, args);
+		}
+		return;
+	}
+
+	// The message is formatted first so that it can be compared with the previous messages.
+	char message[LineBufferSize];
+
 	va_list argsCopy;
 	va_copy(argsCopy, args);
 
-	int formattedStringLength = std::vsnprintf(nullptr, 0, format, argsCopy);
+	const int messageLength = std::vsnprintf(message, sizeof(message), format, argsCopy);
 
 	va_end(argsCopy);
 
-	if (formattedStringLength > 0)
+	if (messageLength <= 0)
 	{
-		size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
+		return;
+	}
 
-		std::unique_ptr<char[]> buffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
+	if (static_cast<size_t>(messageLength) >= sizeof(message))
+	{
+		// The lines that do not fit in the buffer are only subject to the category limits.
+		if (rateLimiter.ShouldWrite(options, nullptr, 0))
+		{
+			WriteLineFormattedUnfiltered(format, args);
+		}
+	}
+	else if (rateLimiter.ShouldWrite(options, message, static_cast<size_t>(messageLength)))
+	{
+		if (traceWriter)
+		{
+			// The trace stores the format arguments instead of the formatted message.
+			traceWriter->WriteLineFormatted(format, args);
+		}
+		else
+		{
+			WriteLineUnfiltered(message);
+		}
+	}
+}
 
-		std::vsnprintf(buffer.get(), formattedStringLengthWithNull, format, args);
+void Logger::EndRateLimitPeriod()
+{
+	if (rateLimiter.IsActive())
+	{
+		rateLimiter.EndPeriod(rateLimitSummaries);
+		WriteRateLimitSummaries();
+	}
+}
 
-		WriteLineCore(buffer.get());
+void Logger::WriteRateLimitSummaries()
+{
+	for (const std::string& summary : rateLimitSummaries)
+	{
+		WriteLineUnfiltered(summary.c_str());
 	}
 
-	va_end(args);
+	rateLimitSummaries.clear();
 }
 
 void Logger::WriteLineCore(const char* const message)
 {
 #ifdef _DEBUG
-	PrintLineToDebugOutput(message);
+	Platform::WriteDebugOutputLine(message);
+#endif // _DEBUG
+
+	if (IsFileOpen())
+	{
+		char timeStamp[64]{};
+
+		const int timeStampLength = FormatTimeStamp(timeStamp, sizeof(timeStamp), Platform::GetLocalTime());
+
+		if (timeStampLength > 0)
+		{
+			WriteToFile(timeStamp, static_cast<size_t>(timeStampLength));
+		}
+
+		WriteToFile(message, std::strlen(message));
+		WriteToFile("\n", 1);
+		FlushFileBuffer();
+	}
+}
+
+void Logger::WriteLineFormattedCore(const char* const format, va_list args)
+{
+	// The timestamp and the message are formatted into a single buffer, which
+	// is written to the log file with one call.
+	char buffer[LineBufferSize];
+
+	const int timeStampLength = FormatTimeStamp(buffer, sizeof(buffer), Platform::GetLocalTime());
+
+	if (timeStampLength < 0)
+	{
+		return;
+	}
+
+	const size_t messageOffset = static_cast<size_t>(timeStampLength);
+	const size_t messageCapacity = sizeof(buffer) - messageOffset;
+
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+
+	const int messageLength = std::vsnprintf(buffer + messageOffset, messageCapacity, format, argsCopy);
+
+	va_end(argsCopy);
+
+	if (messageLength <= 0)
+	{
+		return;
+	}
+
+	char* line = buffer;
+	std::unique_ptr<char[]> largeBuffer;
+
+	if (static_cast<size_t>(messageLength) >= messageCapacity)
+	{
+		const size_t largeBufferSize = messageOffset + static_cast<size_t>(messageLength) + 1;
+
+		largeBuffer = std::make_unique_for_overwrite<char[]>(largeBufferSize);
+		std::memcpy(largeBuffer.get(), buffer, messageOffset);
+		std::vsnprintf(largeBuffer.get() + messageOffset, largeBufferSize - messageOffset, format, args);
+
+		line = largeBuffer.get();
+	}
+
+#ifdef _DEBUG
+	Platform::WriteDebugOutputLine(line + messageOffset);
+#endif // _DEBUG
+
+	if (IsFileOpen())
+	{
+		// The null terminator is replaced with the line ending.
+		const size_t lineLength = messageOffset + static_cast<size_t>(messageLength);
+		line[lineLength] = '\n';
+
+		WriteToFile(line, lineLength + 1);
+		FlushFileBuffer();
+	}
+}
+
+void Logger::QueueLine(const char* const message, uint16_t flags)
+{
+#ifdef _DEBUG
+	Platform::WriteDebugOutputLine(message);
 #endif // _DEBUG
 
-	if (initialized && logFile)
+	LogRingBuffer::Record* record = ringBuffer->BeginWrite();
+
+	if (!record)
 	{
-		logFile << GetTimeStamp() << message << std::endl;
+		droppedLineCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	size_t length = std::strlen(message);
+
+	if (length >= LogRingBuffer::MessageCapacity)
+	{
+		length = LogRingBuffer::MessageCapacity - 1;
+		flags |= LogRingBuffer::Truncated;
+	}
+
+	std::memcpy(record->message, message, length);
+	record->message[length] = '\0';
+	record->length = static_cast<uint16_t>(length);
+	record->flags = flags;
+
+	if ((flags & LogRingBuffer::NoTimestamp) == 0)
+	{
+		record->time = Platform::GetLocalTime();
+	}
+
+	CompleteQueuedLine();
+}
+
+void Logger::QueueLineFormatted(const char* const format, va_list args)
+{
+	LogRingBuffer::Record* record = ringBuffer->BeginWrite();
+
+	if (!record)
+	{
+		droppedLineCount.fetch_add(1, std::memory_order_relaxed);
+		return;
 	}
-}
\ No newline at end of file
+
+	// The message is formatted directly into the ring buffer record.
+	int length = std::vsnprintf(record->message, LogRingBuffer::MessageCapacity, format, args);
+	uint16_t flags = LogRingBuffer::None;
+
+	if (length < 0)
+	{
+		length = 0;
+		record->message[0] = '\0';
+	}
+	else if (static_cast<size_t>(length) >= LogRingBuffer::MessageCapacity)
+	{
+		length = LogRingBuffer::MessageCapacity - 1;
+		flags |= LogRingBuffer::Truncated;
+	}
+
+#ifdef _DEBUG
+	Platform::WriteDebugOutputLine(record->message);
+#endif // _DEBUG
+
+	record->length = static_cast<uint16_t>(length);
+	record->flags = flags;
+	record->time = Platform::GetLocalTime();
+
+	CompleteQueuedLine();
+}
+
+void Logger::CompleteQueuedLine()
+{
+	ringBuffer->EndWrite();
+
+	// The background thread is woken early when the buffer is half full,
+	// otherwise it writes the queued lines at a fixed interval.
+	if (++queuedLinesSinceWake >= (RingBufferCapacity / 2))
+	{
+		queuedLinesSinceWake = 0;
+		writeRequested.store(true, std::memory_order_relaxed);
+		writerWakeCondition.notify_one();
+	}
+}
+
+void Logger::WriteQueuedLines()
+{
+	writeBatch.clear();
+
+	while (const LogRingBuffer::Record* record = ringBuffer->BeginRead())
+	{
+		if ((record->flags & LogRingBuffer::NoTimestamp) == 0)
+		{
+			AppendTimeStamp(writeBatch, record->time);
+		}
+
+		writeBatch.append(record->message, record->length);
+
+		if ((record->flags & LogRingBuffer::Truncated) != 0)
+		{
+			writeBatch.append("...");
+		}
+
+		writeBatch.push_back('\n');
+		ringBuffer->EndRead();
+
+		if (writeBatch.size() >= MaxWriteBatchSize)
+		{
+			WriteToFile(writeBatch.data(), writeBatch.size());
+			writeBatch.clear();
+		}
+	}
+
+	const uint64_t droppedLines = droppedLineCount.load(std::memory_order_relaxed);
+
+	if (droppedLines != reportedDroppedLineCount)
+	{
+		AppendTimeStamp(writeBatch, Platform::GetLocalTime());
+		writeBatch.append(std::to_string(droppedLines - reportedDroppedLineCount));
+		writeBatch.append(" log lines were dropped because the log buffer was full.\n");
+
+		reportedDroppedLineCount = droppedLines;
+	}
+
+	if (!writeBatch.empty())
+	{
+		WriteToFile(writeBatch.data(), writeBatch.size());
+	}
+
+	FlushFileBuffer();
+}
+
+bool Logger::IsFileOpen() const
+{
+	return initialized && (mappedFile.IsOpen() || logFile);
+}
+
+void Logger::WriteToFile(const char* const data, size_t length)
+{
+	if (mappedFile.IsOpen())
+	{
+		mappedFile.Write(data, length);
+	}
+	else
+	{
+		logFile.write(data, static_cast<std::streamsize>(length));
+	}
+}
+
+void Logger::FlushFileBuffer()
+{
+	// The lines written to the memory-mapped file are already in the OS page cache.
+	if (!mappedFile.IsOpen())
+	{
+		logFile.flush();
+	}
+}
+
+void Logger::WriterThreadProc()
+{
+	std::unique_lock<std::mutex> lock(writerMutex);
+
+	while (true)
+	{
+		writerWakeCondition.wait_for(
+			lock,
+			WriterThreadInterval,
+			[&]
+			{
+				return stopWriterThread
+					|| flushRequestCount != flushCompleteCount
+					|| writeRequested.load(std::memory_order_relaxed);
+			});
+
+		const bool stop = stopWriterThread;
+		const uint64_t flushRequest = flushRequestCount;
+		const bool flushRequested = flushRequest != flushCompleteCount;
+
+		writeRequested.store(false, std::memory_order_relaxed);
+
+		std::string block;
+		block.swap(pendingBlock);
+
+		lock.unlock();
+		WriteQueuedLines();
+
+		if (!block.empty())
+		{
+			WriteToFile(block.data(), block.size());
+			FlushFileBuffer();
+		}
+
+		if (flushRequested && mappedFile.IsOpen())
+		{
+			mappedFile.Flush();
+		}
+
+		lock.lock();
+
+		if (flushRequest != flushCompleteCount)
+		{
+			flushCompleteCount = flushRequest;
+			flushCompleteCondition.notify_all();
+		}
+
+		if (stop)
+		{
+			break;
+		}
+	}
+}
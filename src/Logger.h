@@ -12,8 +12,20 @@
 
 #pragma once
 
+#include "BinaryTraceWriter.h"
+#include "LogRateLimiter.h"
+#include "LogRingBuffer.h"
+#include "MappedLogFile.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 enum class LogOptions : int32_t
 {
@@ -22,10 +34,11 @@ enum class LogOptions : int32_t
 	OrdinanceAPI = 1 << 1,
 	OrdinancePropertyAPI = 1 << 2,
 	DumpRegisteredOrdinances = 1 << 3,
-	All = Errors | OrdinanceAPI | OrdinancePropertyAPI | DumpRegisteredOrdinances
+	EntryPointStatistics = 1 << 4,
+	All = Errors | OrdinanceAPI | OrdinancePropertyAPI | DumpRegisteredOrdinances | EntryPointStatistics
 };
 
-inline LogOptions operator|(LogOptions lhs, LogOptions rhs)
+constexpr LogOptions operator|(LogOptions lhs, LogOptions rhs)
 {
 	return static_cast<LogOptions>(
 		static_cast<std::underlying_type<LogOptions>::type>(lhs) |
@@ -33,7 +46,7 @@ inline LogOptions operator|(LogOptions lhs, LogOptions rhs)
 		);
 }
 
-inline LogOptions operator&(LogOptions lhs, LogOptions rhs)
+constexpr LogOptions operator&(LogOptions lhs, LogOptions rhs)
 {
 	return static_cast<LogOptions>(
 		static_cast<std::underlying_type<LogOptions>::type>(lhs) &
@@ -41,13 +54,99 @@ inline LogOptions operator&(LogOptions lhs, LogOptions rhs)
 		);
 }
 
+// The log categories that are compiled into the plugin.
+// Release builds only keep the Errors and EntryPointStatistics categories, the calls for
+// the other categories are removed by the compiler. Debug builds, or builds that define SC4_DIAGNOSTIC_LOGGING,
+// keep all of the categories and select them at run time.
+#if defined(_DEBUG) || defined(SC4_DIAGNOSTIC_LOGGING)
+constexpr LogOptions CompiledLogOptions = LogOptions::All;
+#else
+constexpr LogOptions CompiledLogOptions = LogOptions::Errors | LogOptions::EntryPointStatistics;
+#endif
+
+/**
+ * @brief Determines if a log category is compiled into the plugin.
+ * @tparam Category The log category.
+ * @return True if the category is compiled in; otherwise, false.
+*/
+template <LogOptions Category>
+constexpr bool IsLogCategoryCompiled()
+{
+	return (CompiledLogOptions & Category) != LogOptions::None;
+}
+
+enum class LogWriteMode
+{
+	// Each line is written to the log file by the calling thread.
+	Synchronous,
+	// The lines are queued in a ring buffer and written to the log file in
+	// batches by a background thread. The logging methods must only be called
+	// from a single thread, the game's main thread.
+	Asynchronous,
+	// The lines are recorded in the compact binary trace format by the calling
+	// thread, the SC4LogDecoder tool converts the trace to text or CSV.
+	BinaryTrace
+};
+
 class Logger
 {
 public:
 
 	static Logger& GetInstance();
 
-	void Init(std::filesystem::path logFilePath, LogOptions logLevel);
+	/**
+	 * @brief Opens the log file.
+	 * @param logFilePath The log file path.
+	 * @param logLevel The log categories that are enabled.
+	 * @param writeMode The write mode.
+	 * @param maxFileSize If this is not zero, the text log is written through a memory-mapped
+	 * file with this size. When the file is full it is rotated to a single backup file.
+	*/
+	void Init(
+		std::filesystem::path logFilePath,
+		LogOptions logLevel,
+		LogWriteMode writeMode = LogWriteMode::Synchronous,
+		size_t maxFileSize = 0);
+
+	/**
+	 * @brief Waits until all of the queued lines have been written to the log file.
+	*/
+	void Flush();
+
+	/**
+	 * @brief Writes the queued lines and stops the background thread.
+	 * This must be called before the process starts to exit when using the
+	 * asynchronous write mode.
+	*/
+	void Shutdown();
+
+	/**
+	 * @brief Gets the number of lines that were dropped because the ring buffer was full.
+	 * @return The number of lines that were dropped.
+	*/
+	uint64_t GetDroppedLineCount() const;
+
+	/**
+	 * @brief Collapses repeated identical lines within each sim month.
+	 * The first occurrence of a line is written, and a "(repeated N times)" summary is
+	 * written when the sim month ends or the log is flushed.
+	 * @param enabled True to deduplicate the log lines; otherwise, false.
+	*/
+	void SetDeduplicationEnabled(bool enabled);
+
+	/**
+	 * @brief Sets the maximum number of lines that a log category can write per sim month.
+	 * @param category The log category.
+	 * @param maxLines The maximum number of lines, 0 removes the limit.
+	*/
+	void SetMonthlyLineLimit(LogOptions category, uint32_t maxLines);
+
+	/**
+	 * @brief Sets the simulation month that is recorded in the binary trace,
+	 * and that the deduplication and line limits are counted in.
+	 * @param simMonth The simulation month, year * 12 + month.
+	*/
+	void SetSimMonth(uint32_t simMonth);
 
 	bool IsEnabled(LogOptions option) const;
 
@@ -57,15 +156,94 @@ public:
 
 	void WriteLineFormatted(LogOptions level, const char* const format, ...);
 
+	/**
+	 * @brief Writes a block of lines to the log file with one write, the first line
+	 * is prefixed with the timestamp.
+	 * This is used for the multi-line dumps that do not fit in a log line, the block
+	 * is not deduplicated or counted in the monthly line limits.
+	 * @param level The log category.
+	 * @param text The lines to write, separated by newlines.
+	*/
+	void WriteBlock(LogOptions level, const std::string& text);
+
+	/**
+	 * @brief Writes a line if the category is compiled in and enabled.
+	 * The call is removed by the compiler when the category is not compiled in.
+	 * @tparam Category The log category.
+	 * @param message The message to write.
+	*/
+	template <LogOptions Category>
+	void WriteLine(const char* const message)
+	{
+		if constexpr (IsLogCategoryCompiled<Category>())
+		{
+			WriteLine(Category, message);
+		}
+	}
+
+	/**
+	 * @brief Writes a formatted line if the category is compiled in and enabled.
+	 * The call and its arguments are removed by the compiler when the category
+	 * is not compiled in.
+	 * @tparam Category The log category.
+	 * @param format The printf-style format string.
+	 * @param args The format arguments.
+	*/
+	template <LogOptions Category, typename... Args>
+	void WriteLineFormatted(const char* const format, Args... args)
+	{
+		if constexpr (IsLogCategoryCompiled<Category>())
+		{
+			WriteLineFormatted(Category, format, args...);
+		}
+	}
+
 private:
 
 	Logger();
 	~Logger();
 
+	bool IsFileOpen() const;
+	void WriteToFile(const char* const data, size_t length);
+	void FlushFileBuffer();
+	void WriteLineUnfiltered(const char* const message);
+	void WriteLineFormattedUnfiltered(const char* const format, va_list args);
+	void WriteLineFormattedRateLimited(LogOptions options, const char* const format, va_list args);
+	void EndRateLimitPeriod();
+	void WriteRateLimitSummaries();
 	void WriteLineCore(const char* const message);
+	void WriteLineFormattedCore(const char* const format, va_list args);
+	void QueueLine(const char* const message, uint16_t flags);
+	void QueueLineFormatted(const char* const format, va_list args);
+	void CompleteQueuedLine();
+	void WriteQueuedLines();
+	void WriterThreadProc();
 
 	bool initialized;
 	LogOptions logOptions;
 	std::ofstream logFile;
+	MappedLogFile mappedFile;
+
+	LogRateLimiter rateLimiter;
+	std::vector<std::string> rateLimitSummaries;
+
+	// The binary trace write mode.
+	std::unique_ptr<BinaryTraceWriter> traceWriter;
+
+	// The state used by the asynchronous write mode.
+	std::unique_ptr<LogRingBuffer> ringBuffer;
+	std::thread writerThread;
+	std::mutex writerMutex;
+	std::condition_variable writerWakeCondition;
+	std::condition_variable flushCompleteCondition;
+	uint64_t flushRequestCount;
+	uint64_t flushCompleteCount;
+	std::atomic<uint64_t> droppedLineCount;
+	uint64_t reportedDroppedLineCount;
+	size_t queuedLinesSinceWake;
+	std::atomic<bool> writeRequested;
+	bool stopWriterThread;
+	std::string writeBatch;
+	std::string pendingBlock;
 };
 
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "MappedLogFile.h"
+#include <algorithm>
+#include <cstring>
+
+MappedLogFile::MappedLogFile()
+	: path(), backupPath(), file(), position(0)
+{
+}
+
+MappedLogFile::~MappedLogFile()
+{
+	Close();
+}
+
+bool MappedLogFile::Open(const std::filesystem::path& path, size_t maxFileSize)
+{
+	Close();
+
+	this->path = path;
+
+	backupPath = path.parent_path();
+	backupPath /= path.stem();
+	backupPath += ".1";
+	backupPath += path.extension();
+
+	std::error_code ec;
+	std::filesystem::remove(backupPath, ec);
+
+	position = 0;
+
+	return Platform::CreateMappedFile(path, maxFileSize, file);
+}
+
+void MappedLogFile::Close()
+{
+	Platform::CloseMappedFile(file, position);
+	position = 0;
+}
+
+bool MappedLogFile::IsOpen() const
+{
+	return file.data != nullptr;
+}
+
+void MappedLogFile::Write(const char* data, size_t length)
+{
+	if (!file.data)
+	{
+		return;
+	}
+
+	if (length > (file.size - position) && position > 0)
+	{
+		if (!Rotate())
+		{
+			return;
+		}
+	}
+
+	const size_t count = std::min(length, file.size - position);
+
+	std::memcpy(static_cast<char*>(file.data) + position, data, count);
+	position += count;
+}
+
+void MappedLogFile::Flush()
+{
+	Platform::FlushMappedFile(file);
+}
+
+bool MappedLogFile::Rotate()
+{
+	const size_t maxFileSize = file.size;
+
+	Platform::CloseMappedFile(file, position);
+	position = 0;
+
+	std::error_code ec;
+	std::filesystem::rename(path, backupPath, ec);
+
+	return Platform::CreateMappedFile(path, maxFileSize, file);
+}
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Platform.h"
+#include <cstddef>
+#include <filesystem>
+
+// A log file that is written through a fixed-size memory mapping.
+// When the file is full it is renamed to <name>.1<extension>, replacing the
+// previous backup, and a new file is started. The disk space that is used is
+// limited to two times the maximum file size.
+// The written lines are in the OS page cache as soon as they are copied into
+// the mapping, so they are kept if the process crashes.
+class MappedLogFile
+{
+public:
+
+	MappedLogFile();
+	~MappedLogFile();
+
+	MappedLogFile(const MappedLogFile&) = delete;
+	MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+	/**
+	 * @brief Creates the log file and removes the backup file from a previous session.
+	 * @param path The log file path.
+	 * @param maxFileSize The maximum size of each log file.
+	 * @return True if the file was created; otherwise, false.
+	*/
+	bool Open(const std::filesystem::path& path, size_t maxFileSize);
+
+	/**
+	 * @brief Closes the log file and truncates it to the written size.
+	*/
+	void Close();
+
+	bool IsOpen() const;
+
+	/**
+	 * @brief Copies the data into the log file, rotating the file when it is full.
+	 * Data that is larger than the maximum file size is truncated.
+	 * @param data The data to write.
+	 * @param length The length of the data.
+	*/
+	void Write(const char* data, size_t length);
+
+	/**
+	 * @brief Starts writing the log file to disk.
+	*/
+	void Flush();
+
+private:
+
+	bool Rotate();
+
+	std::filesystem::path path;
+	std::filesystem::path backupPath;
+	Platform::MappedFile file;
+	size_t position;
+};
@@ -11,8 +11,11 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "OrdinanceBase.h"
+#include "EntryPointStatistics.h"
+#include "SaveRecordCodec.h"
 #include "StringResourceKey.h"
 #include "StringResourceManager.h"
+#include "TraceEventRecorder.h"
 #include "cIGZDate.h"
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
@@ -281,30 +284,32 @@ OrdinanceBase& OrdinanceBase::operator=(OrdinanceBase&& other) noexcept
 
 bool OrdinanceBase::QueryInterface(uint32_t riid, void** ppvObj)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceQueryInterface);
+
 	if (riid == GZIID_OrdinanceBase)
 	{
-		AddRef();
+		++refCount;
 		*ppvObj = this;
 
 		return true;
 	}
 	else if (riid == GZIID_cISC4Ordinance)
 	{
-		AddRef();
+		++refCount;
 		*ppvObj = static_cast<cISC4Ordinance*>(this);
 
 		return true;
 	}
 	else if (riid == GZIID_cIGZSerializable)
 	{
-		AddRef();
+		++refCount;
 		*ppvObj = static_cast<cIGZSerializable*>(this);
 
 		return true;
 	}
 	else if (riid == GZIID_cIGZUnknown)
 	{
-		AddRef();
+		++refCount;
 		*ppvObj = static_cast<cIGZUnknown*>(static_cast<cISC4Ordinance*>(this));
 
 		return true;
@@ -315,11 +320,15 @@ bool OrdinanceBase::QueryInterface(uint32_t riid, void** ppvObj)
 
 uint32_t OrdinanceBase::AddRef()
 {
+	EntryPointScope scope(EntryPoint::OrdinanceAddRef);
+
 	return ++refCount;
 }
 
 uint32_t OrdinanceBase::Release()
 {
+	EntryPointScope scope(EntryPoint::OrdinanceRelease);
+
 	if (refCount > 0)
 	{
 		--refCount;
@@ -329,6 +338,8 @@ uint32_t OrdinanceBase::Release()
 
 bool OrdinanceBase::Init(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceInit);
+
 	if (!haveDeserialized)
 	{
 		enabled = true;
@@ -338,15 +349,25 @@ bool OrdinanceBase::Init(void)
 
 bool OrdinanceBase::Shutdown(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceShutdown);
+
 	enabled = false;
 	return true;
 }
 
 int64_t OrdinanceBase::GetCurrentMonthlyIncome(void)
 {
-	const int64_t monthlyConstantIncome = GetMonthlyConstantIncome();
-	const double monthlyIncomeFactor = GetMonthlyIncomeFactor();
+	EntryPointScope scope(EntryPoint::OrdinanceGetCurrentMonthlyIncome);
+
+	return CalculateCurrentMonthlyIncome();
+}
+
+int64_t OrdinanceBase::CalculateCurrentMonthlyIncome()
+{
+	TraceEventScope traceScope("OrdinanceBase::CalculateCurrentMonthlyIncome");
 
+	// The fields are read directly, the GetMonthlyConstantIncome and GetMonthlyIncomeFactor
+	// entry points only count the calls from the game.
 	if (!pResidentialSimulator)
 	{
 		return monthlyConstantIncome;
@@ -373,8 +394,7 @@ int64_t OrdinanceBase::GetCurrentMonthlyIncome(void)
 		monthlyIncomeInteger = static_cast<int64_t>(monthlyIncome);
 	}
 
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: monthly income: constant=%lld, factor=%f, population=%d, current=%lld",
 		__FUNCTION__,
 		monthlyConstantIncome,
@@ -387,26 +407,36 @@ int64_t OrdinanceBase::GetCurrentMonthlyIncome(void)
 
 uint32_t OrdinanceBase::GetID(void) const
 {
+	EntryPointScope scope(EntryPoint::OrdinanceGetID);
+
 	return clsid;
 }
 
 cIGZString* OrdinanceBase::GetName(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceGetName);
+
 	return &name;
 }
 
 cIGZString* OrdinanceBase::GetDescription(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceGetDescription);
+
 	return &description;
 }
 
 uint32_t OrdinanceBase::GetYearFirstAvailable(void)
 {
-	return 0;
+	EntryPointScope scope(EntryPoint::OrdinanceGetYearFirstAvailable);
+
+	return YearFirstAvailable();
 }
 
 SC4Percentage OrdinanceBase::GetChanceAvailability(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceGetChanceAvailability);
+
 	SC4Percentage percentage{ 100.0f };
 
 	return percentage;
@@ -414,46 +444,59 @@ SC4Percentage OrdinanceBase::GetChanceAvailability(void)
 
 int64_t OrdinanceBase::GetEnactmentIncome(void)
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceGetEnactmentIncome);
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
 	return enactmentIncome;
 }
 
 int64_t OrdinanceBase::GetRetracmentIncome(void)
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceGetRetracmentIncome);
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
 	return retracmentIncome;
 }
 
 int64_t OrdinanceBase::GetMonthlyConstantIncome(void)
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceGetMonthlyConstantIncome);
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
 	return monthlyConstantIncome;
 }
 
 float OrdinanceBase::GetMonthlyIncomeFactor(void)
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceGetMonthlyIncomeFactor);
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
 	return monthlyIncomeFactor;
 }
 
 cISCPropertyHolder* OrdinanceBase::GetMiscProperties()
 {
+	EntryPointScope scope(EntryPoint::OrdinanceGetMiscProperties);
+
 	return &miscProperties;
 }
 
 uint32_t OrdinanceBase::GetAdvisorID(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceGetAdvisorID);
+
 	return 0;
 }
 
 bool OrdinanceBase::IsAvailable(void)
 {
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	EntryPointScope scope(EntryPoint::OrdinanceIsAvailable);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: result=%d",
 		__FUNCTION__,
 		available);
@@ -463,10 +506,11 @@ bool OrdinanceBase::IsAvailable(void)
 
 bool OrdinanceBase::IsOn(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceIsOn);
+
 	bool result = available && on;
 
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: result=%d",
 		__FUNCTION__,
 		result);
@@ -476,8 +520,9 @@ bool OrdinanceBase::IsOn(void)
 
 bool OrdinanceBase::IsEnabled(void)
 {
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	EntryPointScope scope(EntryPoint::OrdinanceIsEnabled);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: result=%d",
 		__FUNCTION__,
 		enabled);
@@ -487,8 +532,9 @@ bool OrdinanceBase::IsEnabled(void)
 
 int64_t OrdinanceBase::GetMonthlyAdjustedIncome(void)
 {
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	EntryPointScope scope(EntryPoint::OrdinanceGetMonthlyAdjustedIncome);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: result=%lld",
 		__FUNCTION__,
 		monthlyAdjustedIncome);
@@ -498,6 +544,8 @@ int64_t OrdinanceBase::GetMonthlyAdjustedIncome(void)
 
 bool OrdinanceBase::CheckConditions(void)
 {
+	EntryPointScope scope(EntryPoint::OrdinanceCheckConditions);
+
 	bool result = false;
 
 	if (enabled)
@@ -508,13 +556,12 @@ bool OrdinanceBase::CheckConditions(void)
 
 			if (simDate)
 			{
-				result = simDate->Year() >= GetYearFirstAvailable();
+				result = simDate->Year() >= YearFirstAvailable();
 			}
 		}
 	}
 
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: result=%d",
 		__FUNCTION__,
 		result);
@@ -524,17 +571,26 @@ bool OrdinanceBase::CheckConditions(void)
 
 bool OrdinanceBase::IsIncomeOrdinance(void)
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceIsIncomeOrdinance);
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
 	return isIncomeOrdinance;
 }
 
 bool OrdinanceBase::Simulate(void)
 {
-	monthlyAdjustedIncome = GetCurrentMonthlyIncome();
+	EntryPointScope scope(EntryPoint::OrdinanceSimulate);
+	TraceEventScope traceScope("OrdinanceBase::Simulate");
+
+	const uint32_t simMonth = GetCurrentSimMonth();
+
+	logger.SetSimMonth(simMonth);
+	TraceEventRecorder::GetInstance().SetSimMonth(simMonth);
 
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	monthlyAdjustedIncome = CalculateCurrentMonthlyIncome();
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: monthlyAdjustedIncome=%lld",
 		__FUNCTION__,
 		monthlyAdjustedIncome);
@@ -544,70 +600,87 @@ bool OrdinanceBase::Simulate(void)
 
 bool OrdinanceBase::SetAvailable(bool isAvailable)
 {
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	EntryPointScope scope(EntryPoint::OrdinanceSetAvailable);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: value=%d",
 		__FUNCTION__,
 		isAvailable);
 
-	available = isAvailable;
-	monthlyAdjustedIncome = 0;
+	UpdateAvailable(isAvailable);
 	return true;
 }
 
 bool OrdinanceBase::SetOn(bool isOn)
 {
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	EntryPointScope scope(EntryPoint::OrdinanceSetOn);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: value=%d",
 		__FUNCTION__,
 		isOn);
 
-	on = isOn;
-
-	if (isOn)
-	{
-		monthlyAdjustedIncome = enactmentIncome;
-	}
-	else
-	{
-		monthlyAdjustedIncome = retracmentIncome;
-	}
-
+	UpdateOn(isOn);
 	return true;
 }
 
 bool OrdinanceBase::SetEnabled(bool isEnabled)
 {
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	EntryPointScope scope(EntryPoint::OrdinanceSetEnabled);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: value=%d",
 		__FUNCTION__,
 		isEnabled);
 
-	enabled = isEnabled;
+	UpdateEnabled(isEnabled);
 	return true;
 }
 
 bool OrdinanceBase::ForceAvailable(bool isAvailable)
 {
-	return SetAvailable(isAvailable);
+	EntryPointScope scope(EntryPoint::OrdinanceForceAvailable);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
+		"%s: value=%d",
+		__FUNCTION__,
+		isAvailable);
+
+	UpdateAvailable(isAvailable);
+	return true;
 }
 
 bool OrdinanceBase::ForceOn(bool isOn)
 {
-	return SetOn(isOn);
+	EntryPointScope scope(EntryPoint::OrdinanceForceOn);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
+		"%s: value=%d",
+		__FUNCTION__,
+		isOn);
+
+	UpdateOn(isOn);
+	return true;
 }
 
 bool OrdinanceBase::ForceEnabled(bool isEnabled)
 {
-	return SetEnabled(isEnabled);
+	EntryPointScope scope(EntryPoint::OrdinanceForceEnabled);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
+		"%s: value=%d",
+		__FUNCTION__,
+		isEnabled);
+
+	UpdateEnabled(isEnabled);
+	return true;
 }
 
 bool OrdinanceBase::ForceMonthlyAdjustedIncome(int64_t monthlyAdjustedIncome)
 {
-	logger.WriteLineFormatted(
-		LogOptions::OrdinanceAPI,
+	EntryPointScope scope(EntryPoint::OrdinanceForceMonthlyAdjustedIncome);
+
+	logger.WriteLineFormatted<LogOptions::OrdinanceAPI>(
 		"%s: value=%lld",
 		__FUNCTION__,
 		monthlyAdjustedIncome);
@@ -618,6 +691,9 @@ bool OrdinanceBase::ForceMonthlyAdjustedIncome(int64_t monthlyAdjustedIncome)
 
 bool OrdinanceBase::PostCityInit(cISC4City* pCity)
 {
+	EntryPointScope scope(EntryPoint::OrdinancePostCityInit);
+	TraceEventScope traceScope("OrdinanceBase::PostCityInit");
+
 	bool result = false;
 
 	if (pCity)
@@ -627,6 +703,10 @@ bool OrdinanceBase::PostCityInit(cISC4City* pCity)
 
 		if (pResidentialSimulator && pSimulator)
 		{
+			TraceEventRecorder& traceRecorder = TraceEventRecorder::GetInstance();
+			traceRecorder.SetCitySerialNumber(pCity->GetCitySerialNumber());
+			traceRecorder.SetSimMonth(GetCurrentSimMonth());
+
 			result = Init();
 
 			if (result)
@@ -641,14 +721,61 @@ bool OrdinanceBase::PostCityInit(cISC4City* pCity)
 
 bool OrdinanceBase::PreCityShutdown(cISC4City* pCity)
 {
+	EntryPointScope scope(EntryPoint::OrdinancePreCityShutdown);
+
 	bool result = Shutdown();
 
+	TraceEventRecorder& traceRecorder = TraceEventRecorder::GetInstance();
+	traceRecorder.SetCitySerialNumber(0);
+	traceRecorder.SetSimMonth(0);
+
 	pResidentialSimulator = nullptr;
 	pSimulator = nullptr;
 
 	return result;
 }
 
+OrdinanceBase::State OrdinanceBase::GetState() const
+{
+	State state{};
+	state.id = clsid;
+	state.name = &name;
+	state.available = available;
+	state.on = available && on;
+	state.enabled = enabled;
+	state.isIncomeOrdinance = isIncomeOrdinance;
+	state.enactmentIncome = enactmentIncome;
+	state.retracmentIncome = retracmentIncome;
+	state.monthlyConstantIncome = monthlyConstantIncome;
+	state.monthlyIncomeFactor = monthlyIncomeFactor;
+	state.monthlyAdjustedIncome = monthlyAdjustedIncome;
+	state.effects = &miscProperties;
+
+	return state;
+}
+
+uint32_t OrdinanceBase::YearFirstAvailable() const
+{
+	return 0;
+}
+
+uint32_t OrdinanceBase::GetCurrentSimMonth()
+{
+	uint32_t result = 0;
+
+	if (pSimulator)
+	{
+		cIGZDate* simDate = pSimulator->GetSimDate();
+
+		if (simDate)
+		{
+			result = (simDate->Year() * 12) + simDate->Month();
+		}
+	}
+
+	return result;
+}
+
 bool OrdinanceBase::ReadBool(cIGZIStream& stream, bool& value)
 {
 	uint8_t temp = 0;
@@ -671,112 +798,195 @@ bool OrdinanceBase::WriteBool(cIGZOStream& stream, bool value)
 
 bool OrdinanceBase::Write(cIGZOStream& stream)
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceWrite);
+	TraceEventScope traceScope("OrdinanceBase::Write");
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
 	if (stream.GetError() != 0)
 	{
 		return false;
 	}
 
-	const uint32_t version = 1;
-	if (!stream.SetUint32(version))
-	{
-		return false;
-	}
+	// The name and description are not saved, they are replaced by the localized
+	// strings when the city is loaded.
+	return WriteTaggedRecord(stream);
+}
 
-	if (!stream.SetUint32(clsid))
-	{
-		return false;
-	}
+bool OrdinanceBase::Read(cIGZIStream& stream)
+{
+	EntryPointScope scope(EntryPoint::OrdinanceRead);
+	TraceEventScope traceScope("OrdinanceBase::Read");
 
-	if (!stream.SetGZStr(name))
-	{
-		return false;
-	}
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
-	if (!stream.SetGZStr(description))
+	if (stream.GetError() != 0)
 	{
 		return false;
 	}
 
-	if (!stream.SetSint64(enactmentIncome))
+	uint32_t version = 0;
+	if (!stream.GetUint32(version))
 	{
 		return false;
 	}
 
-	if (!stream.SetSint64(retracmentIncome))
-	{
-		return false;
-	}
+	bool result = false;
 
-	if (!stream.SetSint64(retracmentIncome))
+	switch (version)
 	{
-		return false;
+	case 1:
+		result = ReadVersion1(stream);
+		break;
+	default:
+		// A newer version is read by skipping the sections that this build does not know.
+		if (version >= TaggedSaveVersion)
+		{
+			result = ReadTaggedRecord(stream);
+		}
+		break;
 	}
 
-	if (!stream.SetSint64(monthlyConstantIncome))
+	if (result)
 	{
-		return false;
+		haveDeserialized = true;
 	}
 
-	if (!stream.SetSint64(monthlyAdjustedIncome))
+	return result;
+}
+
+uint8_t OrdinanceBase::GetSaveFlags() const
+{
+	uint8_t flags = 0;
+
+	if (isIncomeOrdinance)
 	{
-		return false;
+		flags |= SaveFlagIsIncomeOrdinance;
 	}
 
-	if (!stream.SetFloat32(monthlyIncomeFactor))
+	if (initialized)
 	{
-		return false;
+		flags |= SaveFlagInitialized;
 	}
 
-	if (!WriteBool(stream, isIncomeOrdinance))
+	if (available)
 	{
-		return false;
+		flags |= SaveFlagAvailable;
 	}
 
-	if (!miscProperties.Write(stream))
+	if (on)
 	{
-		return false;
+		flags |= SaveFlagOn;
 	}
 
-	if (!WriteBool(stream, initialized))
+	if (enabled)
 	{
-		return false;
+		flags |= SaveFlagEnabled;
 	}
 
-	if (!WriteBool(stream, available))
+	return flags;
+}
+
+void OrdinanceBase::SetSaveFlags(uint8_t flags)
+{
+	isIncomeOrdinance = (flags & SaveFlagIsIncomeOrdinance) != 0;
+	initialized = (flags & SaveFlagInitialized) != 0;
+	available = (flags & SaveFlagAvailable) != 0;
+	on = (flags & SaveFlagOn) != 0;
+	enabled = (flags & SaveFlagEnabled) != 0;
+}
+
+bool OrdinanceBase::WriteTaggedRecord(cIGZOStream& stream) const
+{
+	SaveRecordWriter writer(TaggedSaveVersion);
+
+	if (!WriteSaveSections(writer))
 	{
 		return false;
 	}
 
-	if (!WriteBool(stream, on))
+	return writer.WriteTo(stream);
+}
+
+bool OrdinanceBase::ReadTaggedRecord(cIGZIStream& stream)
+{
+	SaveRecordReader reader;
+
+	if (!reader.ReadFrom(stream))
 	{
 		return false;
 	}
 
-	if (!WriteBool(stream, enabled))
+	SaveRecordReader section;
+
+	while (reader.GetRemainingSize() > 0)
 	{
-		return false;
+		uint16_t tag = 0;
+
+		if (!reader.ReadSection(tag, section) || !ReadSaveSection(tag, section))
+		{
+			return false;
+		}
 	}
 
 	return true;
 }
 
-bool OrdinanceBase::Read(cIGZIStream& stream)
+bool OrdinanceBase::WriteSaveSections(SaveRecordWriter& writer) const
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
-
-	if (stream.GetError() != 0)
+	const size_t ordinanceSection = writer.BeginSection(SaveSectionOrdinance);
+	writer.WriteUint32(clsid);
+	writer.WriteVarint(enactmentIncome);
+	writer.WriteVarint(retracmentIncome);
+	writer.WriteVarint(monthlyConstantIncome);
+	writer.WriteVarint(monthlyAdjustedIncome);
+	writer.WriteFloat32(monthlyIncomeFactor);
+	writer.WriteUint8(GetSaveFlags());
+	writer.EndSection(ordinanceSection);
+
+	const size_t propertiesSection = writer.BeginSection(SaveSectionProperties);
+
+	if (!miscProperties.Write(writer))
 	{
 		return false;
 	}
 
-	uint32_t version = 0;
-	if (!stream.GetUint32(version) || version != 1)
+	writer.EndSection(propertiesSection);
+	return true;
+}
+
+bool OrdinanceBase::ReadSaveSection(uint16_t tag, SaveRecordReader& section)
+{
+	switch (tag)
 	{
-		return false;
+	case SaveSectionOrdinance:
+	{
+		uint8_t flags = 0;
+
+		if (!section.ReadUint32(clsid)
+			|| !section.ReadVarint(enactmentIncome)
+			|| !section.ReadVarint(retracmentIncome)
+			|| !section.ReadVarint(monthlyConstantIncome)
+			|| !section.ReadVarint(monthlyAdjustedIncome)
+			|| !section.ReadFloat32(monthlyIncomeFactor)
+			|| !section.ReadUint8(flags))
+		{
+			return false;
+		}
+
+		SetSaveFlags(flags);
+		return true;
 	}
+	case SaveSectionProperties:
+		return miscProperties.Read(section);
+	default:
+		// A section that was added by a newer version.
+		return true;
+	}
+}
 
+bool OrdinanceBase::ReadVersion1(cIGZIStream& stream)
+{
 	if (!stream.GetUint32(clsid))
 	{
 		return false;
@@ -827,7 +1037,7 @@ bool OrdinanceBase::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	if (!miscProperties.Read(stream))
+	if (!miscProperties.ReadVersion1(stream))
 	{
 		return false;
 	}
@@ -852,19 +1062,47 @@ bool OrdinanceBase::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	haveDeserialized = true;
 	return true;
 }
 
 uint32_t OrdinanceBase::GetGZCLSID()
 {
-	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
+	EntryPointScope scope(EntryPoint::OrdinanceGetGZCLSID);
+
+	logger.WriteLine<LogOptions::OrdinanceAPI>(__FUNCTION__);
 
 	return clsid;
 }
 
+void OrdinanceBase::UpdateAvailable(bool isAvailable)
+{
+	available = isAvailable;
+	monthlyAdjustedIncome = 0;
+}
+
+void OrdinanceBase::UpdateOn(bool isOn)
+{
+	on = isOn;
+
+	if (isOn)
+	{
+		monthlyAdjustedIncome = enactmentIncome;
+	}
+	else
+	{
+		monthlyAdjustedIncome = retracmentIncome;
+	}
+}
+
+void OrdinanceBase::UpdateEnabled(bool isEnabled)
+{
+	enabled = isEnabled;
+}
+
 void OrdinanceBase::LoadLocalizedStringResources()
 {
+	TraceEventScope traceScope("OrdinanceBase::LoadLocalizedStringResources");
+
 	cIGZString* localizedName = nullptr;
 	cIGZString* localizedDescription = nullptr;
 
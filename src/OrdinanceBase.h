@@ -19,6 +19,9 @@
 #include "Logger.h"
 #include "StringResourceKey.h"
 
+class SaveRecordReader;
+class SaveRecordWriter;
+
 // The base class for a custom ordinance.
 class OrdinanceBase : public cISC4Ordinance, protected cIGZSerializable
 {
@@ -139,11 +142,9 @@ public:
 	/**
 	 * @brief Gets the monthly income/expense for this ordinance.
 	 * @return The monthly income/expense for this ordinance.
-	 * @remarks This method uses a default algorithm of
-	 * <monthly constent income> + (<city population> x <monthly income factor>).
-	 * This method can be overridden to use a custom algorithm.
+	 * @remarks The income is calculated by CalculateCurrentMonthlyIncome.
 	*/
-	virtual int64_t GetCurrentMonthlyIncome(void);
+	int64_t GetCurrentMonthlyIncome(void);
 
 	/**
 	 * @brief Gets the unique ordinance ID.
@@ -166,12 +167,9 @@ public:
 	/**
 	 * @brief Gets the in-game year that the ordinance becomes available.
 	 * @return The in-game year that the ordinance becomes available.
-	 *
-	 * @remarks By default the ordinances will be available at the start of the game.
-	 * This method can be overridden to set a custom start year.
-	 * Note that in SimCity 4 the in-game date starts in the year 2000.
+	 * @remarks The year is provided by YearFirstAvailable.
 	*/
-	virtual uint32_t GetYearFirstAvailable(void);
+	uint32_t GetYearFirstAvailable(void);
 
 	/**
 	 * @brief The chance that the ordinance will become available each month.
@@ -233,7 +231,7 @@ public:
 	/**
 	 * @brief Defines the conditions that are required for the ordinance to become available.
 	 * @return True if the ordinance should become available in the menu; otherwise, false.
-	 * @remarks By default the only required condition is the starting year @see GetYearFirstAvailable.
+	 * @remarks By default the only required condition is the starting year @see YearFirstAvailable.
 	 * This method can be overridden to provide custom conditions for the ordinance availability.
 	*/
 	virtual bool CheckConditions(void);
@@ -280,8 +278,118 @@ public:
 	*/
 	virtual bool PreCityShutdown(cISC4City* pCity);
 
+	// The values that the cISC4Ordinance getters return, for the plugin's own use.
+	// The getters count each call as a call from the game in EntryPointStatistics.
+	struct State
+	{
+		uint32_t id;
+		const cIGZString* name;
+		bool available;
+		bool on;
+		bool enabled;
+		bool isIncomeOrdinance;
+		int64_t enactmentIncome;
+		int64_t retracmentIncome;
+		int64_t monthlyConstantIncome;
+		float monthlyIncomeFactor;
+		int64_t monthlyAdjustedIncome;
+		const OrdinancePropertyHolder* effects;
+	};
+
+	/**
+	 * @brief Gets the ordinance state without counting any entry point calls.
+	 * @return The ordinance state.
+	*/
+	State GetState() const;
+
 protected:
 
+	/**
+	 * @brief Gets a value that identifies the current in-game month.
+	 * @return The in-game month as <year> * 12 + <month>, or zero if the
+	 * ordinance is not attached to a city.
+	*/
+	uint32_t GetCurrentSimMonth();
+
+	// The methods that the game calls count the call in EntryPointStatistics and then
+	// use the methods below, which the ordinance also calls itself.
+
+	/**
+	 * @brief Calculates the monthly income/expense for this ordinance.
+	 * @return The monthly income/expense for this ordinance.
+	 * @remarks This method uses a default algorithm of
+	 * <monthly constent income> + (<city population> x <monthly income factor>).
+	 * This method can be overridden to use a custom algorithm.
+	*/
+	virtual int64_t CalculateCurrentMonthlyIncome();
+
+	/**
+	 * @brief Gets the in-game year that the ordinance becomes available.
+	 * @return The in-game year that the ordinance becomes available.
+	 *
+	 * @remarks By default the ordinances will be available at the start of the game.
+	 * This method can be overridden to set a custom start year.
+	 * Note that in SimCity 4 the in-game date starts in the year 2000.
+	*/
+	virtual uint32_t YearFirstAvailable() const;
+
+	// The bool fields of the tagged save records, packed into one byte.
+	enum SaveFlags : uint8_t
+	{
+		SaveFlagIsIncomeOrdinance = 1 << 0,
+		SaveFlagInitialized = 1 << 1,
+		SaveFlagAvailable = 1 << 2,
+		SaveFlagOn = 1 << 3,
+		SaveFlagEnabled = 1 << 4,
+	};
+
+	uint8_t GetSaveFlags() const;
+	void SetSaveFlags(uint8_t flags);
+
+	// Version 1 is the save format of the released plugin, version 2 and later are
+	// tagged records. The derived classes write the same version, an older build
+	// skips the sections that they add.
+	static constexpr uint32_t TaggedSaveVersion = 2;
+
+	// The section tags of the tagged save records, see SaveRecordCodec.h.
+	// The derived classes use the same list so that the tags do not collide.
+	enum SaveSectionTag : uint16_t
+	{
+		SaveSectionOrdinance = 1,
+		SaveSectionProperties = 2,
+		SaveSectionResidentialIncomeFactors = 3,
+	};
+
+	/**
+	 * @brief Writes a tagged save record.
+	 * @param stream The stream to write to.
+	 * @return True if the record was written; otherwise, false.
+	*/
+	bool WriteTaggedRecord(cIGZOStream& stream) const;
+
+	/**
+	 * @brief Reads a tagged save record, the caller has already read the record version.
+	 * @param stream The stream to read from.
+	 * @return True if the record was read; otherwise, false.
+	*/
+	bool ReadTaggedRecord(cIGZIStream& stream);
+
+	/**
+	 * @brief Writes the sections of a tagged save record.
+	 * @param writer The record writer.
+	 * @return True if the sections were written; otherwise, false.
+	*/
+	virtual bool WriteSaveSections(SaveRecordWriter& writer) const;
+
+	/**
+	 * @brief Reads a section of a tagged save record.
+	 * @param tag The section tag.
+	 * @param section The section data.
+	 * @return True if the section was read or was skipped because the tag is unknown;
+	 * otherwise, false if the section is corrupt.
+	*/
+	virtual bool ReadSaveSection(uint16_t tag, SaveRecordReader& section);
+
 	static bool ReadBool(cIGZIStream& stream, bool& value);
 	static bool WriteBool(cIGZOStream& stream, bool value);
 
@@ -309,6 +417,12 @@ protected:
 
 private:
 
+	bool ReadVersion1(cIGZIStream& stream);
+
+	void UpdateAvailable(bool isAvailable);
+	void UpdateOn(bool isOn);
+	void UpdateEnabled(bool isEnabled);
+
 	void LoadLocalizedStringResources();
 
 	uint32_t refCount;
@@ -11,178 +11,115 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "OrdinancePropertyHolder.h"
+#include "EntryPointStatistics.h"
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
+#include "cISC4DBSegmentIStream.h"
+#include "cISC4DBSegmentOStream.h"
 #include "Logger.h"
+#include "Platform.h"
+#include "SaveRecordCodec.h"
+#include <algorithm>
 
 static constexpr uint32_t GZCLSID_OrdinancePropertyHolder = 0xd0f95c79;
 static constexpr uint32_t GZIID_OrdinancePropertyHolder = 0x84672560;
 
+// The property count is read from the save file, it is only trusted up to this
+// value when reserving the storage for the properties.
+static constexpr uint32_t MaxReservedPropertyCount = 256;
+
 namespace
 {
-	const char* GetPropertyDescription(uint32_t propertyID)
+	// The same format as cSCBaseProperty::Write(cIGZOStream&), using a DB segment
+	// interface that the caller queries once for all of the properties.
+	bool WriteProperty(cISC4DBSegmentOStream& dbSegment, const cSCBaseProperty& property)
 	{
-		const char* value = nullptr;
+		return dbSegment.SetUint32(property.GetPropertyID())
+			&& dbSegment.WriteVariant(*property.GetPropertyValue());
+	}
 
-		switch (propertyID)
+	bool ReadProperty(cISC4DBSegmentIStream& dbSegment, cSCBaseProperty& property)
+	{
+		uint32_t propertyID = 0;
+
+		if (!dbSegment.GetUint32(propertyID))
 		{
-		case 0x28ed0380:
-			value = "Crime Effect (float32[1])";
-			break;
-		case 0xaa5b8407:
-			value = "Mayor Rating (int32[1])";
-			break;
-		case 0x08f79b8e:
-			value = "Air Effect (float32[1])";
-			break;
-		case 0x28f42aa0:
-			value = "Flammability Effect (float32[1])";
-			break;
-		case 0xe8f79c8b:
-			value = "Water Effect (float32[1])";
-			break;
-		case 0xe8f79c90:
-			value = "Garbage Effect (float32[1])";
-			break;
-		case 0xa8f4eb0c:
-			value = "Water Use Reduction (float32[1])";
-			break;
-		case 0x0911e117:
-			value = "Power Reduction Effect (float32[1])";
-			break;
-		case 0x2a633000:
-			value = "Commercial Demand Effect (float32[1])";
-			break;
-		case 0x2a653110:
-			value = "Demand Effect:Cs$ (float32[1])";
-			break;
-		case 0x2a653120:
-			value = "Demand Effect:Cs$$ (float32[1])";
-			break;
-		case 0x2a653130:
-			value = "Demand Effect:Cs$$$ (float32[1])";
-			break;
-		case 0x2a653320:
-			value = "Demand Effect:Co$$ (float32[1])";
-			break;
-		case 0x2a653330:
-			value = "Demand Effect:Co$$$ (float32[1])";
-			break;
-		case 0x2a634000:
-			value = "Industrial Demand Effect (float32[1])";
-			break;
-		case 0x2a654100:
-			value = "Demand Effect:IR (float32[1])";
-			break;
-		case 0x2a654200:
-			value = "Demand Effect:ID (float32[1])";
-			break;
-		case 0x2a654300:
-			value = "Demand Effect:IM (float32[1])";
-			break;
-		case 0x2a654400:
-			value = "Demand Effect:IHT (float32[1])";
-			break;
-		case 0x491b3ad5:
-			value = "Health Coverage Radius % Effect (float32[1])";
-			break;
-		case 0x891b3ae6:
-			value = "Health Effectiveness vs. Distance Effect (float32, general response curve)";
-			break;
-		case 0xe91b3aee:
-			value = "Health Quotient Boost Effect (float32[1])";
-			break;
-		case 0xc92d9c7a:
-			value = "Health Quotient Decay Effect (float32[1])";
-			break;
-		case 0x092d909b:
-			value = "Health Capacity Effect (float32[1])";
-			break;
-		case 0xe92d9db4:
-			value = "Health Effectiveness vs. Average Age Effect (float32, general response curve)";
-			break;
-		case 0xa91b3af4:
-			value = "School Coverage Radius % Effect (float32[1])";
-			break;
-		case 0xa91b3afa:
-			value = "School Effectiveness vs. Distance Effect (float32, general response curve)";
-			break;
-		case 0xa92d9d7a:
-			value = "School EQ Boost Effect (float32[1])";
-			break;
-		case 0x692ef65a:
-			value = "School EQ Decay Effect (float32[1])";
-			break;
-		case 0x892d9d02:
-			value = "School Capacity Effect (float32[1])";
-			break;
-		case 0xc91b3b02:
-			value = "School Effectiveness vs. Average Age Effect (float32, general response curve)";
-			break;
-		case 0x8a612fee:
-			value = "Travel Strategy Modifier (int32[9])";
-			break;
-		case 0x8a67e373:
-			value = "Air Effect by zone type (float32[16])";
-			break;
-		case 0x8a67e374:
-			value = "Water Effect by zone type (float32[16])";
-			break;
-		case 0x8a67e376:
-			value = "Garbage Effect by zone type (float32[16])";
-			break;
-		case 0x8a67e378:
-			value = "Traffic Air Pollution Effect (float32[1])";
-			break;
+			return false;
 		}
 
-		return value;
+		property.SetPropertyID(propertyID);
+
+		return dbSegment.ReadVariant(*property.GetPropertyValue());
 	}
 
 	void LogPropertyId(const char* methodName, uint32_t propertyId)
 	{
-		Logger& logger = Logger::GetInstance();
-
-		const char* propertyDescription = GetPropertyDescription(propertyId);
-
-		if (propertyDescription)
-		{
-			logger.WriteLineFormatted(
-				LogOptions::OrdinancePropertyAPI,
-				"%s: propertyId=0x%08x (%s)",
-				methodName,
-				propertyId,
-				propertyDescription);
-		}
-		else
+		if constexpr (IsLogCategoryCompiled<LogOptions::OrdinancePropertyAPI>())
 		{
-			logger.WriteLineFormatted(
-				LogOptions::OrdinancePropertyAPI,
-				"%s: propertyId=0x%08x",
-				methodName,
-				propertyId);
+			Logger& logger = Logger::GetInstance();
+
+			if (!logger.IsEnabled(LogOptions::OrdinancePropertyAPI))
+			{
+				return;
+			}
+
+			const char* propertyDescription = OrdinancePropertyHolder::GetPropertyDescription(propertyId);
+
+			if (propertyDescription)
+			{
+				logger.WriteLineFormatted<LogOptions::OrdinancePropertyAPI>(
+					"%s: propertyId=0x%08x (%s)",
+					methodName,
+					propertyId,
+					propertyDescription);
+			}
+			else
+			{
+				logger.WriteLineFormatted<LogOptions::OrdinancePropertyAPI>(
+					"%s: propertyId=0x%08x",
+					methodName,
+					propertyId);
+			}
 		}
 	}
 }
 
 OrdinancePropertyHolder::OrdinancePropertyHolder()
-	: refCount(0), properties()
+	: OrdinancePropertyHolder(DuplicatePropertyMode::Keep)
+{
+}
+
+OrdinancePropertyHolder::OrdinancePropertyHolder(DuplicatePropertyMode duplicatePropertyMode)
+	: refCount(0), propertySet(), duplicatePropertyMode(duplicatePropertyMode), propertySetExposed(false)
 {
 }
 
 OrdinancePropertyHolder::OrdinancePropertyHolder(const std::vector<cSCBaseProperty>& properties)
-	: refCount(0), properties(properties)
+	: refCount(0), propertySet(), duplicatePropertyMode(DuplicatePropertyMode::Keep), propertySetExposed(false)
 {
+	if (!properties.empty())
+	{
+		PropertySet& set = ResetPropertySet();
+		set.properties.assign(properties.begin(), properties.end());
+
+		SortProperties();
+	}
 }
 
 OrdinancePropertyHolder::OrdinancePropertyHolder(const OrdinancePropertyHolder& other)
-	: refCount(0), properties(other.properties)
+	: refCount(0),
+	  propertySet(other.SharePropertySet()),
+	  duplicatePropertyMode(other.duplicatePropertyMode),
+	  propertySetExposed(false)
 {
 
 }
 
 OrdinancePropertyHolder::OrdinancePropertyHolder(OrdinancePropertyHolder&& other) noexcept
-	: refCount(0), properties(std::move(other.properties))
+	: refCount(0),
+	  propertySet(std::move(other.propertySet)),
+	  duplicatePropertyMode(other.duplicatePropertyMode),
+	  propertySetExposed(other.propertySetExposed)
 {
 }
 
@@ -197,7 +134,9 @@ OrdinancePropertyHolder& OrdinancePropertyHolder::operator=(const OrdinancePrope
 		return *this;
 	}
 
-	properties = other.properties;
+	propertySet = other.SharePropertySet();
+	duplicatePropertyMode = other.duplicatePropertyMode;
+	propertySetExposed = false;
 
 	return *this;
 }
@@ -209,13 +148,17 @@ OrdinancePropertyHolder& OrdinancePropertyHolder::operator=(OrdinancePropertyHol
 		return *this;
 	}
 
-	properties = std::move(other.properties);
+	propertySet = std::move(other.propertySet);
+	duplicatePropertyMode = other.duplicatePropertyMode;
+	propertySetExposed = other.propertySetExposed;
 
 	return *this;
 }
 
 bool OrdinancePropertyHolder::QueryInterface(uint32_t riid, void** ppvObj)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderQueryInterface);
+
 	if (riid == GZIID_OrdinancePropertyHolder)
 	{
 		AddRef();
@@ -250,11 +193,15 @@ bool OrdinancePropertyHolder::QueryInterface(uint32_t riid, void** ppvObj)
 
 uint32_t OrdinancePropertyHolder::AddRef()
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderAddRef);
+
 	return ++refCount;
 }
 
 uint32_t OrdinancePropertyHolder::Release()
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderRelease);
+
 	if (refCount > 0)
 	{
 		--refCount;
@@ -265,37 +212,35 @@ uint32_t OrdinancePropertyHolder::Release()
 
 bool OrdinancePropertyHolder::HasProperty(uint32_t dwProperty)
 {
-	LogPropertyId(__FUNCTION__, dwProperty);
+	EntryPointScope scope(EntryPoint::PropertyHolderHasProperty);
 
-	for (const auto& property : properties)
-	{
-		if (property.GetPropertyID() == dwProperty)
-		{
-			return true;
-		}
-	}
+	LogPropertyId(__FUNCTION__, dwProperty);
 
-	return false;
+	return FindPropertyIndex(dwProperty) < GetPropertySet().properties.size();
 }
 
 bool OrdinancePropertyHolder::GetPropertyList(cIGZUnknownList** ppList)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderGetPropertyList);
+
 	return false;
 }
 
 cISCProperty* OrdinancePropertyHolder::GetProperty(uint32_t dwProperty)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderGetProperty);
+
 	LogPropertyId(__FUNCSIG__, dwProperty);
 
-	for (auto& property : properties)
+	const size_t index = FindPropertyIndex(dwProperty);
+
+	if (index < GetPropertySet().properties.size())
 	{
-		if (property.GetPropertyID() == dwProperty)
-		{
-			cISCProperty* pProperty = static_cast<cISCProperty*>(&property);
-			pProperty->AddRef();
+		// The caller can modify the property, it must not reach the holders that share the set.
+		cISCProperty* pProperty = &ExposePropertySet().properties[index];
+		pProperty->AddRef();
 
-			return pProperty;
-		}
+		return pProperty;
 	}
 
 	return nullptr;
@@ -303,19 +248,20 @@ cISCProperty* OrdinancePropertyHolder::GetProperty(uint32_t dwProperty)
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, uint32_t& dwValueOut)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderGetPropertyUint32);
+
 	LogPropertyId(__FUNCSIG__, dwProperty);
 
 	bool result = false;
 
-	for (const auto& property : properties)
+	const PropertySet& set = GetPropertySet();
+	const size_t index = FindPropertyIndex(dwProperty);
+
+	if (index < set.properties.size())
 	{
-		if (property.GetPropertyID() == dwProperty)
-		{
-			const auto variant = property.GetPropertyValue();
+		const auto variant = set.properties[index].GetPropertyValue();
 
-			result = variant && variant->GetValUint32(dwValueOut);
-			break;
-		}
+		result = variant && variant->GetValUint32(dwValueOut);
 	}
 
 	return result;
@@ -323,6 +269,8 @@ bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, uint32_t& dwValue
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, cIGZString& szValueOut)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderGetPropertyString);
+
 	LogPropertyId(__FUNCSIG__, dwProperty);
 
 	return false;
@@ -330,6 +278,8 @@ bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, cIGZString& szVal
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, uint32_t riid, void** ppvObj)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderGetPropertyInterface);
+
 	LogPropertyId(__FUNCSIG__, dwProperty);
 
 	return false;
@@ -337,6 +287,8 @@ bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, uint32_t riid, vo
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, void* pUnknown, uint32_t& dwUnknownOut)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderGetPropertyVoid);
+
 	LogPropertyId(__FUNCSIG__, dwProperty);
 
 	return false;
@@ -344,9 +296,11 @@ bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, void* pUnknown, u
 
 bool OrdinancePropertyHolder::AddProperty(cISCProperty* pProperty, bool bUnknown)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderAddProperty);
+
 	if (pProperty)
 	{
-		properties.push_back(cSCBaseProperty(*pProperty));
+		InsertProperty(cSCBaseProperty(*pProperty));
 		return true;
 	}
 
@@ -355,52 +309,68 @@ bool OrdinancePropertyHolder::AddProperty(cISCProperty* pProperty, bool bUnknown
 
 bool OrdinancePropertyHolder::AddProperty(uint32_t dwProperty, cIGZVariant const* pVariant, bool bUnknown)
 {
-	properties.push_back(cSCBaseProperty(dwProperty, pVariant));
+	EntryPointScope scope(EntryPoint::PropertyHolderAddPropertyVariant);
+
+	InsertProperty(cSCBaseProperty(dwProperty, pVariant));
 	return true;
 }
 
 bool OrdinancePropertyHolder::AddProperty(uint32_t dwProperty, uint32_t dwValue, bool bUnknown)
 {
-	properties.push_back(cSCBaseProperty(dwProperty, dwValue));
+	EntryPointScope scope(EntryPoint::PropertyHolderAddPropertyUint32);
+
+	InsertProperty(cSCBaseProperty(dwProperty, dwValue));
 	return true;
 }
 
 bool OrdinancePropertyHolder::AddProperty(uint32_t dwProperty, cIGZString const& szValue)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderAddPropertyString);
+
 	return false;
 }
 
 bool OrdinancePropertyHolder::AddProperty(uint32_t dwProperty, int32_t lValue, bool bUnknown)
 {
-	properties.push_back(cSCBaseProperty(dwProperty, lValue));
+	EntryPointScope scope(EntryPoint::PropertyHolderAddPropertySint32);
+
+	InsertProperty(cSCBaseProperty(dwProperty, lValue));
 	return true;
 }
 
 bool OrdinancePropertyHolder::AddProperty(uint32_t dwProperty, void* pUnknown, uint32_t dwUnknown, bool bUnknown)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderAddPropertyVoid);
+
 	return false;
 }
 
 bool OrdinancePropertyHolder::AddProperty(uint32_t dwProperty, float value)
 {
-	properties.push_back(cSCBaseProperty(dwProperty, value));
+	InsertProperty(cSCBaseProperty(dwProperty, value));
 	return true;
 }
 
 bool OrdinancePropertyHolder::CopyAddProperty(cISCProperty* pProperty, bool bUnknown)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderCopyAddProperty);
+
 	return false;
 }
 
 bool OrdinancePropertyHolder::RemoveProperty(uint32_t dwProperty)
 {
-	for (std::vector<cSCBaseProperty>::iterator it = properties.begin(); it != properties.end();)
+	EntryPointScope scope(EntryPoint::PropertyHolderRemoveProperty);
+
+	const size_t index = FindPropertyIndex(dwProperty);
+
+	if (index < GetPropertySet().properties.size())
 	{
-		if (it->GetPropertyID() == dwProperty)
-		{
-			properties.erase(it);
-			return true;
-		}
+		PropertySet& set = GetMutablePropertySet();
+
+		set.properties.erase(set.properties.begin() + index);
+		set.propertyIDs.erase(set.propertyIDs.begin() + index);
+		return true;
 	}
 
 	return false;
@@ -408,17 +378,28 @@ bool OrdinancePropertyHolder::RemoveProperty(uint32_t dwProperty)
 
 bool OrdinancePropertyHolder::RemoveAllProperties(void)
 {
-	properties.clear();
+	EntryPointScope scope(EntryPoint::PropertyHolderRemoveAllProperties);
+
+	// The holders that share the current set keep it.
+	propertySet.reset();
 	return true;
 }
 
 bool OrdinancePropertyHolder::EnumProperties(FunctionPtr1 pFunction1, void* pData)
 {
-	size_t propertyCount = properties.size();
+	EntryPointScope scope(EntryPoint::PropertyHolderEnumProperties);
+
+	if (!propertySet)
+	{
+		return true;
+	}
+
+	PropertySet& set = ExposePropertySet();
+	size_t propertyCount = set.properties.size();
 
 	for (size_t i = 0; i < propertyCount; i++)
 	{
-		cISCProperty* property = &properties[i];
+		cISCProperty* property = &set.properties[i];
 
 		pFunction1(property, pData);
 	}
@@ -428,21 +409,30 @@ bool OrdinancePropertyHolder::EnumProperties(FunctionPtr1 pFunction1, void* pDat
 
 bool OrdinancePropertyHolder::EnumProperties(FunctionPtr2 pFunction2, FunctionPtr1 pFunctionPipe)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderEnumPropertiesPipe);
+
 	return false;
 }
 
 bool OrdinancePropertyHolder::CompactProperties(void)
 {
-	return false;
+	EntryPointScope scope(EntryPoint::PropertyHolderCompactProperties);
+
+	RemoveDuplicateProperties();
+	return true;
 }
 
 bool OrdinancePropertyHolder::Write(cIGZOStream& stream)
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderWrite);
+
 	if (stream.GetError() != 0)
 	{
 		return false;
 	}
 
+	const auto& properties = GetPropertySet().properties;
+
 	const uint32_t version = 1;
 	const uint32_t propertyCount = static_cast<uint32_t>(properties.size());
 
@@ -451,18 +441,44 @@ bool OrdinancePropertyHolder::Write(cIGZOStream& stream)
 		return false;
 	}
 
+	if (propertyCount == 0)
+	{
+		return true;
+	}
+
+	// The DB segment interface is queried once for all of the properties, instead
+	// of once per property in cSCBaseProperty::Write(cIGZOStream&).
+	cISC4DBSegmentOStream* dbSegment = nullptr;
+
+	if (!stream.QueryInterface(GZIID_cISC4DBSegmentOStream, reinterpret_cast<void**>(&dbSegment)))
+	{
+		return false;
+	}
+
+	bool result = true;
+
 	for (uint32_t i = 0; i < propertyCount; i++)
 	{
-		if (!properties[i].Write(stream))
+		if (!WriteProperty(*dbSegment, properties[i]))
 		{
-			return false;
+			result = false;
+			break;
 		}
 	}
 
-	return true;
+	dbSegment->Release();
+
+	return result;
 }
 
 bool OrdinancePropertyHolder::Read(cIGZIStream& stream)
+{
+	EntryPointScope scope(EntryPoint::PropertyHolderRead);
+
+	return ReadVersion1(stream);
+}
+
+bool OrdinancePropertyHolder::ReadVersion1(cIGZIStream& stream)
 {
 	if (stream.GetError() != 0)
 	{
@@ -481,24 +497,427 @@ bool OrdinancePropertyHolder::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	properties.clear();
+	// The loaded properties replace the set, the holders that share the current set keep it.
+	PropertySet& set = ResetPropertySet();
+	auto& properties = set.properties;
+	auto& propertyIDs = set.propertyIDs;
 
-	for (uint32_t i = 0; i < propertyCount; i++)
+	if (propertyCount > 0)
 	{
-		cSCBaseProperty prop;
+		cISC4DBSegmentIStream* dbSegment = nullptr;
 
-		if (!prop.Read(stream))
+		if (!stream.QueryInterface(GZIID_cISC4DBSegmentIStream, reinterpret_cast<void**>(&dbSegment)))
 		{
 			return false;
 		}
 
-		properties.push_back(prop);
+		const uint32_t reservedCount = std::min(propertyCount, MaxReservedPropertyCount);
+
+		properties.reserve(reservedCount);
+		propertyIDs.reserve(reservedCount);
+
+		bool result = true;
+
+		for (uint32_t i = 0; i < propertyCount; i++)
+		{
+			cSCBaseProperty& prop = properties.emplace_back();
+
+			if (!ReadProperty(*dbSegment, prop))
+			{
+				result = false;
+				break;
+			}
+
+			propertyIDs.push_back(prop.GetPropertyID());
+		}
+
+		dbSegment->Release();
+
+		if (!result)
+		{
+			properties.clear();
+			propertyIDs.clear();
+			return false;
+		}
 	}
 
+	SortLoadedProperties();
+
+	return true;
+}
+
+bool OrdinancePropertyHolder::Write(SaveRecordWriter& writer) const
+{
+	const auto& properties = GetPropertySet().properties;
+
+	writer.WriteVaruint(properties.size());
+
+	for (const cSCBaseProperty& property : properties)
+	{
+		writer.WriteUint32(property.GetPropertyID());
+
+		if (!writer.WriteVariant(*property.GetPropertyValue()))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool OrdinancePropertyHolder::Read(SaveRecordReader& reader)
+{
+	uint64_t propertyCount = 0;
+
+	// Each property takes at least 6 bytes, the ID and the variant type.
+	if (!reader.ReadVaruint(propertyCount) || propertyCount > reader.GetRemainingSize() / 6)
+	{
+		return false;
+	}
+
+	PropertySet& set = ResetPropertySet();
+	auto& properties = set.properties;
+	auto& propertyIDs = set.propertyIDs;
+
+	properties.reserve(static_cast<size_t>(propertyCount));
+	propertyIDs.reserve(static_cast<size_t>(propertyCount));
+
+	for (uint64_t i = 0; i < propertyCount; i++)
+	{
+		uint32_t propertyID = 0;
+
+		if (!reader.ReadUint32(propertyID))
+		{
+			properties.clear();
+			propertyIDs.clear();
+			return false;
+		}
+
+		cSCBaseProperty& prop = properties.emplace_back(propertyID);
+
+		if (!reader.ReadVariant(*prop.GetPropertyValue()))
+		{
+			properties.clear();
+			propertyIDs.clear();
+			return false;
+		}
+
+		propertyIDs.push_back(propertyID);
+	}
+
+	SortLoadedProperties();
+
 	return true;
 }
 
 uint32_t OrdinancePropertyHolder::GetGZCLSID()
 {
+	EntryPointScope scope(EntryPoint::PropertyHolderGetGZCLSID);
+
 	return GZCLSID_OrdinancePropertyHolder;
 }
+
+const OrdinancePropertyHolder::PropertySet& OrdinancePropertyHolder::GetPropertySet() const
+{
+	static const PropertySet emptyPropertySet;
+
+	return propertySet ? *propertySet : emptyPropertySet;
+}
+
+OrdinancePropertyHolder::PropertySet& OrdinancePropertyHolder::GetMutablePropertySet()
+{
+	if (!propertySet)
+	{
+		propertySet = std::make_shared<PropertySet>();
+	}
+	else if (propertySet.use_count() > 1)
+	{
+		propertySet = std::make_shared<PropertySet>(*propertySet);
+	}
+
+	return *propertySet;
+}
+
+std::shared_ptr<OrdinancePropertyHolder::PropertySet> OrdinancePropertyHolder::SharePropertySet() const
+{
+	// The properties of an exposed set can be modified through the pointers that were
+	// handed out, a copy of the holder gets its own set.
+	if (propertySet && propertySetExposed)
+	{
+		return std::make_shared<PropertySet>(*propertySet);
+	}
+
+	return propertySet;
+}
+
+OrdinancePropertyHolder::PropertySet& OrdinancePropertyHolder::ExposePropertySet()
+{
+	PropertySet& set = GetMutablePropertySet();
+	propertySetExposed = true;
+
+	return set;
+}
+
+OrdinancePropertyHolder::PropertySet& OrdinancePropertyHolder::ResetPropertySet()
+{
+	if (propertySet && propertySet.use_count() == 1)
+	{
+		propertySet->properties.clear();
+		propertySet->propertyIDs.clear();
+	}
+	else
+	{
+		propertySet = std::make_shared<PropertySet>();
+	}
+
+	return *propertySet;
+}
+
+size_t OrdinancePropertyHolder::FindPropertyIndex(uint32_t propertyID) const
+{
+	const PropertySet& set = GetPropertySet();
+	const auto it = std::lower_bound(set.propertyIDs.begin(), set.propertyIDs.end(), propertyID);
+
+	if (it != set.propertyIDs.end() && *it == propertyID)
+	{
+		return static_cast<size_t>(it - set.propertyIDs.begin());
+	}
+
+	return set.properties.size();
+}
+
+void OrdinancePropertyHolder::InsertProperty(const cSCBaseProperty& property)
+{
+	const uint32_t propertyID = property.GetPropertyID();
+
+	if (duplicatePropertyMode == DuplicatePropertyMode::Replace)
+	{
+		const size_t existingIndex = FindPropertyIndex(propertyID);
+
+		if (existingIndex < GetPropertySet().properties.size())
+		{
+			GetMutablePropertySet().properties[existingIndex] = property;
+			return;
+		}
+	}
+
+	PropertySet& set = GetMutablePropertySet();
+	auto& properties = set.properties;
+	auto& propertyIDs = set.propertyIDs;
+
+	// The new property is inserted after any existing properties with the same ID.
+	const auto it = std::upper_bound(propertyIDs.begin(), propertyIDs.end(), propertyID);
+	const auto index = it - propertyIDs.begin();
+
+	propertyIDs.insert(it, propertyID);
+	properties.insert(properties.begin() + index, property);
+}
+
+void OrdinancePropertyHolder::SortLoadedProperties()
+{
+	const auto& propertyIDs = GetPropertySet().propertyIDs;
+
+	// The properties are sorted when they are added, but the file may have been
+	// written by an older version that kept them in the order they were added.
+	if (!std::is_sorted(propertyIDs.begin(), propertyIDs.end()))
+	{
+		SortProperties();
+	}
+
+	if (duplicatePropertyMode == DuplicatePropertyMode::Replace
+		&& std::adjacent_find(propertyIDs.begin(), propertyIDs.end()) != propertyIDs.end())
+	{
+		RemoveDuplicateProperties();
+	}
+}
+
+void OrdinancePropertyHolder::RemoveDuplicateProperties()
+{
+	if (!propertySet)
+	{
+		return;
+	}
+
+	const bool hasDuplicates = std::adjacent_find(
+		propertySet->propertyIDs.begin(),
+		propertySet->propertyIDs.end()) != propertySet->propertyIDs.end();
+
+	// A shared set is only copied if compacting it would change its contents.
+	if (!hasDuplicates && propertySet.use_count() > 1)
+	{
+		return;
+	}
+
+	PropertySet& set = GetMutablePropertySet();
+	auto& properties = set.properties;
+	auto& propertyIDs = set.propertyIDs;
+
+	// The properties with the same ID are adjacent and in the order that they
+	// were added, the last property of each run is kept.
+	const size_t propertyCount = properties.size();
+	size_t writeIndex = 0;
+
+	for (size_t i = 0; i < propertyCount; i++)
+	{
+		if (i + 1 < propertyCount && propertyIDs[i + 1] == propertyIDs[i])
+		{
+			continue;
+		}
+
+		if (writeIndex != i)
+		{
+			properties[writeIndex] = std::move(properties[i]);
+			propertyIDs[writeIndex] = propertyIDs[i];
+		}
+
+		writeIndex++;
+	}
+
+	properties.erase(properties.begin() + writeIndex, properties.end());
+	propertyIDs.erase(propertyIDs.begin() + writeIndex, propertyIDs.end());
+
+	properties.shrink_to_fit();
+	propertyIDs.shrink_to_fit();
+}
+
+void OrdinancePropertyHolder::SortProperties()
+{
+	PropertySet& set = GetMutablePropertySet();
+	auto& properties = set.properties;
+	auto& propertyIDs = set.propertyIDs;
+
+	std::stable_sort(
+		properties.begin(),
+		properties.end(),
+		[](const cSCBaseProperty& lhs, const cSCBaseProperty& rhs)
+		{
+			return lhs.GetPropertyID() < rhs.GetPropertyID();
+		});
+
+	propertyIDs.clear();
+	propertyIDs.reserve(properties.size());
+
+	for (const cSCBaseProperty& property : properties)
+	{
+		propertyIDs.push_back(property.GetPropertyID());
+	}
+}
+
+const char* OrdinancePropertyHolder::GetPropertyDescription(uint32_t propertyID)
+{
+	const char* value = nullptr;
+
+	switch (propertyID)
+	{
+	case 0x28ed0380:
+		value = "Crime Effect (float32[1])";
+		break;
+	case 0xaa5b8407:
+		value = "Mayor Rating (int32[1])";
+		break;
+	case 0x08f79b8e:
+		value = "Air Effect (float32[1])";
+		break;
+	case 0x28f42aa0:
+		value = "Flammability Effect (float32[1])";
+		break;
+	case 0xe8f79c8b:
+		value = "Water Effect (float32[1])";
+		break;
+	case 0xe8f79c90:
+		value = "Garbage Effect (float32[1])";
+		break;
+	case 0xa8f4eb0c:
+		value = "Water Use Reduction (float32[1])";
+		break;
+	case 0x0911e117:
+		value = "Power Reduction Effect (float32[1])";
+		break;
+	case 0x2a633000:
+		value = "Commercial Demand Effect (float32[1])";
+		break;
+	case 0x2a653110:
+		value = "Demand Effect:Cs$ (float32[1])";
+		break;
+	case 0x2a653120:
+		value = "Demand Effect:Cs$$ (float32[1])";
+		break;
+	case 0x2a653130:
+		value = "Demand Effect:Cs$$$ (float32[1])";
+		break;
+	case 0x2a653320:
+		value = "Demand Effect:Co$$ (float32[1])";
+		break;
+	case 0x2a653330:
+		value = "Demand Effect:Co$$$ (float32[1])";
+		break;
+	case 0x2a634000:
+		value = "Industrial Demand Effect (float32[1])";
+		break;
+	case 0x2a654100:
+		value = "Demand Effect:IR (float32[1])";
+		break;
+	case 0x2a654200:
+		value = "Demand Effect:ID (float32[1])";
+		break;
+	case 0x2a654300:
+		value = "Demand Effect:IM (float32[1])";
+		break;
+	case 0x2a654400:
+		value = "Demand Effect:IHT (float32[1])";
+		break;
+	case 0x491b3ad5:
+		value = "Health Coverage Radius % Effect (float32[1])";
+		break;
+	case 0x891b3ae6:
+		value = "Health Effectiveness vs. Distance Effect (float32, general response curve)";
+		break;
+	case 0xe91b3aee:
+		value = "Health Quotient Boost Effect (float32[1])";
+		break;
+	case 0xc92d9c7a:
+		value = "Health Quotient Decay Effect (float32[1])";
+		break;
+	case 0x092d909b:
+		value = "Health Capacity Effect (float32[1])";
+		break;
+	case 0xe92d9db4:
+		value = "Health Effectiveness vs. Average Age Effect (float32, general response curve)";
+		break;
+	case 0xa91b3af4:
+		value = "School Coverage Radius % Effect (float32[1])";
+		break;
+	case 0xa91b3afa:
+		value = "School Effectiveness vs. Distance Effect (float32, general response curve)";
+		break;
+	case 0xa92d9d7a:
+		value = "School EQ Boost Effect (float32[1])";
+		break;
+	case 0x692ef65a:
+		value = "School EQ Decay Effect (float32[1])";
+		break;
+	case 0x892d9d02:
+		value = "School Capacity Effect (float32[1])";
+		break;
+	case 0xc91b3b02:
+		value = "School Effectiveness vs. Average Age Effect (float32, general response curve)";
+		break;
+	case 0x8a612fee:
+		value = "Travel Strategy Modifier (int32[9])";
+		break;
+	case 0x8a67e373:
+		value = "Air Effect by zone type (float32[16])";
+		break;
+	case 0x8a67e374:
+		value = "Water Effect by zone type (float32[16])";
+		break;
+	case 0x8a67e376:
+		value = "Garbage Effect by zone type (float32[16])";
+		break;
+	case 0x8a67e378:
+		value = "Traffic Air Pollution Effect (float32[1])";
+		break;
+	}
+
+	return value;
+}
@@ -14,14 +14,46 @@
 #include "cISCPropertyHolder.h"
 #include "cIGZSerializable.h"
 #include "cSCBaseProperty.h"
+#include "boost/container/small_vector.hpp"
+#include <cstddef>
+#include <memory>
 #include <vector>
 
+class SaveRecordReader;
+class SaveRecordWriter;
+
+// The properties are kept sorted by property ID, with the IDs in a parallel array
+// so that the lookups are a binary search over contiguous integers instead of
+// a linear scan that makes a virtual call for each property.
+// Properties with the same ID are kept in the order that they were added, and
+// the lookups return the first one. In DuplicatePropertyMode::Replace adding a
+// property with an existing ID overwrites that property instead.
+//
+// The property set is immutable and shared between the copies of a holder, so
+// applying the settings to an ordinance does not copy the effects that the settings
+// own. The holder copies the set before it is modified if another holder shares it.
+// GetProperty and EnumProperties hand out writable properties, so the holder copies
+// the set before it returns them and never shares that set with its copies again.
+// The game calls them on the ordinance's effects, which costs one copy of the set
+// each time that the settings are applied.
+// Most ordinances have only a few effects, up to InlinePropertyCapacity properties
+// are stored inline in the set so that creating it only makes one allocation.
 class OrdinancePropertyHolder : public cISCPropertyHolder, cIGZSerializable
 {
 public:
 
+	enum class DuplicatePropertyMode
+	{
+		// AddProperty adds a second property when the ID is already present.
+		Keep,
+		// AddProperty replaces the value of an existing property with the same ID.
+		Replace
+	};
+
 	OrdinancePropertyHolder();
 
+	explicit OrdinancePropertyHolder(DuplicatePropertyMode duplicatePropertyMode);
+
 	OrdinancePropertyHolder(const std::vector<cSCBaseProperty>& properties);
 
 	OrdinancePropertyHolder(const OrdinancePropertyHolder& other);
@@ -61,15 +93,86 @@ public:
 	virtual bool EnumProperties(FunctionPtr1 pFunction1, void* pData);
 	virtual bool EnumProperties(FunctionPtr2 pFunction2, FunctionPtr1 pFunctionPipe);
 
+	/**
+	 * @brief Calls a function for each property, for the plugin's own use.
+	 * Unlike EnumProperties this is not counted as a call from the game, and the
+	 * properties are read-only so the set stays shared.
+	 * @param function The function, it takes a const cSCBaseProperty reference.
+	*/
+	template <typename Function>
+	void ForEachProperty(Function function) const
+	{
+		for (const cSCBaseProperty& property : GetPropertySet().properties)
+		{
+			function(property);
+		}
+	}
+
+	/**
+	 * @brief Merges the properties that have the same ID, keeping the value that was
+	 * added last, and releases the unused capacity.
+	 * @return True.
+	*/
 	virtual bool CompactProperties(void);
 
 	bool Write(cIGZOStream& stream);
 	bool Read(cIGZIStream& stream);
 	uint32_t GetGZCLSID();
 
+	/**
+	 * @brief Writes the properties to an ordinance save record.
+	 * @param writer The record writer.
+	 * @return True if the properties were written; otherwise, false.
+	*/
+	bool Write(SaveRecordWriter& writer) const;
+
+	/**
+	 * @brief Reads the properties from an ordinance save record.
+	 * @param reader The record reader.
+	 * @return True if the properties were read; otherwise, false.
+	*/
+	bool Read(SaveRecordReader& reader);
+
+	/**
+	 * @brief Reads the properties in the cISCPropertyHolder::Read format, which the
+	 * version 1 ordinance save records use.
+	 * @param stream The stream to read from.
+	 * @return True if the properties were read; otherwise, false.
+	*/
+	bool ReadVersion1(cIGZIStream& stream);
+
+	/**
+	 * @brief Gets the name and value type of a known ordinance effect property.
+	 * @param propertyID The property ID.
+	 * @return The property description, or nullptr if the property is not known.
+	*/
+	static const char* GetPropertyDescription(uint32_t propertyID);
+
+	static constexpr size_t InlinePropertyCapacity = 8;
+
 private:
-	
+
+	struct PropertySet
+	{
+		boost::container::small_vector<cSCBaseProperty, InlinePropertyCapacity> properties;
+		boost::container::small_vector<uint32_t, InlinePropertyCapacity> propertyIDs;
+	};
+
+	const PropertySet& GetPropertySet() const;
+	PropertySet& GetMutablePropertySet();
+	PropertySet& ResetPropertySet();
+	std::shared_ptr<PropertySet> SharePropertySet() const;
+	PropertySet& ExposePropertySet();
+
+	size_t FindPropertyIndex(uint32_t propertyID) const;
+	void InsertProperty(const cSCBaseProperty& property);
+	void RemoveDuplicateProperties();
+	void SortProperties();
+	void SortLoadedProperties();
+
 	uint32_t refCount;
-	std::vector<cSCBaseProperty> properties;
+	std::shared_ptr<PropertySet> propertySet;
+	DuplicatePropertyMode duplicatePropertyMode;
+	bool propertySetExposed;
 };
 
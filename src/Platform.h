@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// The operating system specific functionality used by the ordinance code.
+// PlatformWin32.cpp is used by the plugin DLL, and PlatformPosix.cpp is used
+// by the host build of the core library.
+
+#ifndef _MSC_VER
+#define __FUNCSIG__ __PRETTY_FUNCTION__
+#endif // !_MSC_VER
+
+namespace Platform
+{
+	struct LocalTime
+	{
+		uint16_t hour;
+		uint16_t minute;
+		uint16_t second;
+		uint16_t milliseconds;
+	};
+
+	/**
+	 * @brief Gets the current local time.
+	 * @return The current local time.
+	*/
+	LocalTime GetLocalTime();
+
+	/**
+	 * @brief Gets the folder that contains the module (DLL or executable) that
+	 * this code was linked into.
+	 * @return The folder that contains the current module.
+	*/
+	std::filesystem::path GetModuleFolderPath();
+
+	/**
+	 * @brief Writes a line to the debugger output.
+	 * @param line The line to write.
+	*/
+	void WriteDebugOutputLine(const char* line);
+
+	struct MappedFile
+	{
+		void* data = nullptr;
+		size_t size = 0;
+		intptr_t fileHandle = -1;
+		intptr_t mappingHandle = -1;
+	};
+
+	/**
+	 * @brief Creates or truncates a file and maps it into memory for writing.
+	 * @param path The file path.
+	 * @param size The size of the file and the mapping.
+	 * @param file Receives the mapped file.
+	 * @return True if the file was mapped; otherwise, false.
+	*/
+	bool CreateMappedFile(const std::filesystem::path& path, size_t size, MappedFile& file);
+
+	/**
+	 * @brief Starts writing the modified pages of a mapped file to disk, without waiting.
+	 * @param file The mapped file.
+	*/
+	void FlushMappedFile(const MappedFile& file);
+
+	/**
+	 * @brief Unmaps and closes a mapped file.
+	 * @param file The mapped file.
+	 * @param fileSize The final size of the file, the rest of the mapping is discarded.
+	*/
+	void CloseMappedFile(MappedFile& file, size_t fileSize);
+}
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "Platform.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+Platform::LocalTime Platform::GetLocalTime()
+{
+	const auto now = std::chrono::system_clock::now();
+	const std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+	const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+
+	std::tm time{};
+	localtime_r(&seconds, &time);
+
+	return LocalTime
+	{
+		static_cast<uint16_t>(time.tm_hour),
+		static_cast<uint16_t>(time.tm_min),
+		static_cast<uint16_t>(time.tm_sec),
+		static_cast<uint16_t>(milliseconds.count())
+	};
+}
+
+std::filesystem::path Platform::GetModuleFolderPath()
+{
+	Dl_info info{};
+
+	if (dladdr(reinterpret_cast<const void*>(&Platform::GetModuleFolderPath), &info) && info.dli_fname)
+	{
+		std::error_code ec;
+		std::filesystem::path modulePath = std::filesystem::canonical(info.dli_fname, ec);
+
+		if (!ec)
+		{
+			return modulePath.parent_path();
+		}
+	}
+
+	return std::filesystem::current_path();
+}
+
+void Platform::WriteDebugOutputLine(const char* line)
+{
+	std::fputs(line, stderr);
+	std::fputc('\n', stderr);
+}
+
+bool Platform::CreateMappedFile(const std::filesystem::path& path, size_t size, MappedFile& file)
+{
+	const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if (data == MAP_FAILED)
+	{
+		close(fd);
+		return false;
+	}
+
+	file.data = data;
+	file.size = size;
+	file.fileHandle = fd;
+	file.mappingHandle = -1;
+
+	return true;
+}
+
+void Platform::FlushMappedFile(const MappedFile& file)
+{
+	if (file.data)
+	{
+		msync(file.data, file.size, MS_ASYNC);
+	}
+}
+
+void Platform::CloseMappedFile(MappedFile& file, size_t fileSize)
+{
+	if (file.data)
+	{
+		munmap(file.data, file.size);
+
+		const int fd = static_cast<int>(file.fileHandle);
+
+		// The file is truncated to the written size, the unused part of the mapping is discarded.
+		// If this fails the file keeps its mapped size and the unused part is filled with zeros.
+		const int result = ftruncate(fd, static_cast<off_t>(fileSize));
+		static_cast<void>(result);
+
+		close(fd);
+
+		file = MappedFile();
+	}
+}
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "Platform.h"
+#include <Windows.h>
+#include "wil/resource.h"
+#include "wil/win32_helpers.h"
+
+Platform::LocalTime Platform::GetLocalTime()
+{
+	SYSTEMTIME time;
+
+	::GetLocalTime(&time);
+
+	return LocalTime{ time.wHour, time.wMinute, time.wSecond, time.wMilliseconds };
+}
+
+std::filesystem::path Platform::GetModuleFolderPath()
+{
+	wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(wil::GetModuleInstanceHandle());
+
+	std::filesystem::path temp(modulePath.get());
+
+	return temp.parent_path();
+}
+
+void Platform::WriteDebugOutputLine(const char* line)
+{
+	OutputDebugStringA(line);
+	OutputDebugStringA("\n");
+}
+
+bool Platform::CreateMappedFile(const std::filesystem::path& path, size_t size, MappedFile& file)
+{
+	wil::unique_hfile hFile(CreateFileW(
+		path.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ,
+		nullptr,
+		CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr));
+
+	if (!hFile)
+	{
+		return false;
+	}
+
+	const uint64_t mappingSize = size;
+
+	// The file is extended to the mapping size.
+	wil::unique_handle hMapping(CreateFileMappingW(
+		hFile.get(),
+		nullptr,
+		PAGE_READWRITE,
+		static_cast<DWORD>(mappingSize >> 32),
+		static_cast<DWORD>(mappingSize & 0xffffffff),
+		nullptr));
+
+	if (!hMapping)
+	{
+		return false;
+	}
+
+	void* data = MapViewOfFile(hMapping.get(), FILE_MAP_WRITE, 0, 0, size);
+
+	if (!data)
+	{
+		return false;
+	}
+
+	file.data = data;
+	file.size = size;
+	file.fileHandle = reinterpret_cast<intptr_t>(hFile.release());
+	file.mappingHandle = reinterpret_cast<intptr_t>(hMapping.release());
+
+	return true;
+}
+
+void Platform::FlushMappedFile(const MappedFile& file)
+{
+	if (file.data)
+	{
+		FlushViewOfFile(file.data, file.size);
+	}
+}
+
+void Platform::CloseMappedFile(MappedFile& file, size_t fileSize)
+{
+	if (file.data)
+	{
+		UnmapViewOfFile(file.data);
+		CloseHandle(reinterpret_cast<HANDLE>(file.mappingHandle));
+
+		HANDLE hFile = reinterpret_cast<HANDLE>(file.fileHandle);
+
+		LARGE_INTEGER position{};
+		position.QuadPart = static_cast<LONGLONG>(fileSize);
+
+		// The file is truncated to the written size, the unused part of the mapping is discarded.
+		if (SetFilePointerEx(hFile, position, nullptr, FILE_BEGIN))
+		{
+			SetEndOfFile(hFile);
+		}
+
+		CloseHandle(hFile);
+
+		file = MappedFile();
+	}
+}
@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+// The census groups that can contribute to the population-based income.
+// The residential IDs are the population of each wealth group, the commercial
+// and industrial IDs are the number of jobs of each type.
+namespace CensusGroupID
+{
+	constexpr uint32_t ResidentialLowWealth = 0x1011;
+	constexpr uint32_t ResidentialMedWealth = 0x1021;
+	constexpr uint32_t ResidentialHighWealth = 0x1031;
+	constexpr uint32_t CommercialServiceLowWealth = 0x3111;
+	constexpr uint32_t CommercialServiceMedWealth = 0x3121;
+	constexpr uint32_t CommercialServiceHighWealth = 0x3131;
+	constexpr uint32_t CommercialOfficeMedWealth = 0x3321;
+	constexpr uint32_t CommercialOfficeHighWealth = 0x3331;
+	constexpr uint32_t IndustrialAgriculture = 0x4101;
+	constexpr uint32_t IndustrialDirty = 0x4201;
+	constexpr uint32_t IndustrialManufacturing = 0x4301;
+	constexpr uint32_t IndustrialHighTech = 0x4401;
+}
+
+// A census group and the amount of income that each member of the group
+// contributes to the monthly income.
+struct PopulationIncomeFactor
+{
+	uint32_t demandGroupID;
+	float factor;
+};
@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "RegisteredOrdinanceDump.h"
+#include "OrdinanceBase.h"
+#include "OrdinancePropertyHolder.h"
+#include "cIGZString.h"
+#include "cIGZVariant.h"
+#include "cISC4Ordinance.h"
+#include "cISC4OrdinanceSimulator.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	// The game has about 30 built-in ordinances, this leaves room for the plugin ordinances.
+	constexpr uint32_t InitialOrdinanceIDCapacity = 256;
+
+	// The largest array that is written in full, the known effects use at most 16 values.
+	constexpr uint32_t MaxArrayValueCount = 16;
+
+	struct EffectDumpContext
+	{
+		std::string& output;
+		uint32_t propertyCount;
+	};
+
+	void AppendFormatted(std::string& output, const char* format, ...)
+	{
+		char buffer[512]{};
+
+		va_list args;
+		va_start(args, format);
+
+		const int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+
+		va_end(args);
+
+		if (length > 0)
+		{
+			output.append(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+		}
+	}
+
+	template <typename T>
+	void AppendArray(std::string& output, const T* values, uint32_t count, const char* format)
+	{
+		const uint32_t writtenCount = std::min(count, MaxArrayValueCount);
+
+		output.push_back('[');
+
+		for (uint32_t i = 0; i < writtenCount; i++)
+		{
+			if (i > 0)
+			{
+				output.append(", ");
+			}
+
+			AppendFormatted(output, format, values[i]);
+		}
+
+		if (writtenCount < count)
+		{
+			output.append(", ...");
+		}
+
+		output.push_back(']');
+	}
+
+	void AppendVariantValue(std::string& output, const cIGZVariant& value)
+	{
+		const uint16_t type = value.GetType();
+		const uint32_t count = value.GetCount();
+
+		switch (type)
+		{
+		case cIGZVariant::Bool:
+			AppendFormatted(output, "%d", value.GetValBool());
+			break;
+		case cIGZVariant::Uint8:
+			AppendFormatted(output, "%u", value.GetValUint8());
+			break;
+		case cIGZVariant::Sint8:
+			AppendFormatted(output, "%d", value.GetValSint8());
+			break;
+		case cIGZVariant::Uint16:
+			AppendFormatted(output, "%u", value.GetValUint16());
+			break;
+		case cIGZVariant::Sint16:
+			AppendFormatted(output, "%d", value.GetValSint16());
+			break;
+		case cIGZVariant::Uint32:
+			AppendFormatted(output, "0x%08x", value.GetValUint32());
+			break;
+		case cIGZVariant::Sint32:
+			AppendFormatted(output, "%d", value.GetValSint32());
+			break;
+		case cIGZVariant::Uint64:
+			AppendFormatted(output, "%" PRIu64, value.GetValUint64());
+			break;
+		case cIGZVariant::Sint64:
+			AppendFormatted(output, "%" PRId64, value.GetValSint64());
+			break;
+		case cIGZVariant::Float32:
+			AppendFormatted(output, "%g", value.GetValFloat32());
+			break;
+		case cIGZVariant::Float64:
+			AppendFormatted(output, "%g", value.GetValFloat64());
+			break;
+		case cIGZVariant::Uint32Array:
+			AppendArray(output, value.RefUint32(), count, "0x%08x");
+			break;
+		case cIGZVariant::Sint32Array:
+			AppendArray(output, value.RefSint32(), count, "%d");
+			break;
+		case cIGZVariant::Float32Array:
+			AppendArray(output, value.RefFloat32(), count, "%g");
+			break;
+		default:
+			AppendFormatted(output, "<type 0x%04x, %u values>", type, count);
+			break;
+		}
+	}
+
+	void AppendEffect(std::string& output, uint32_t propertyID, const cIGZVariant* value)
+	{
+		const char* description = OrdinancePropertyHolder::GetPropertyDescription(propertyID);
+
+		if (description)
+		{
+			AppendFormatted(output, "    effect 0x%08x %s = ", propertyID, description);
+		}
+		else
+		{
+			AppendFormatted(output, "    effect 0x%08x = ", propertyID);
+		}
+
+		if (value)
+		{
+			AppendVariantValue(output, *value);
+		}
+		else
+		{
+			output.append("<null>");
+		}
+
+		output.push_back('\n');
+	}
+
+	void AppendEffectProperty(cISCProperty* pProperty, void* pData)
+	{
+		EffectDumpContext* context = static_cast<EffectDumpContext*>(pData);
+
+		AppendEffect(context->output, pProperty->GetPropertyID(), pProperty->GetPropertyValue());
+		context->propertyCount++;
+	}
+
+	OrdinanceBase::State GetOrdinanceState(cISC4Ordinance& ordinance)
+	{
+		OrdinanceBase::State state{};
+		state.id = ordinance.GetID();
+		state.name = ordinance.GetName();
+		state.available = ordinance.IsAvailable();
+		state.on = ordinance.IsOn();
+		state.enabled = ordinance.IsEnabled();
+		state.isIncomeOrdinance = ordinance.IsIncomeOrdinance();
+		state.enactmentIncome = ordinance.GetEnactmentIncome();
+		state.retracmentIncome = ordinance.GetRetracmentIncome();
+		state.monthlyConstantIncome = ordinance.GetMonthlyConstantIncome();
+		state.monthlyIncomeFactor = ordinance.GetMonthlyIncomeFactor();
+		state.monthlyAdjustedIncome = ordinance.GetMonthlyAdjustedIncome();
+		state.effects = nullptr;
+
+		return state;
+	}
+
+	void AppendOrdinanceState(std::string& output, const OrdinanceBase::State& state, uint32_t& onCount)
+	{
+		if (state.on)
+		{
+			onCount++;
+		}
+
+		AppendFormatted(
+			output,
+			"  0x%08x \"%s\": available=%d, on=%d, enabled=%d, incomeOrdinance=%d, enactment=%" PRId64
+			", retracment=%" PRId64 ", monthlyConstant=%" PRId64 ", monthlyFactor=%f, monthlyAdjusted=%" PRId64 "\n",
+			state.id,
+			state.name ? state.name->ToChar() : "",
+			state.available,
+			state.on,
+			state.enabled,
+			state.isIncomeOrdinance,
+			state.enactmentIncome,
+			state.retracmentIncome,
+			state.monthlyConstantIncome,
+			state.monthlyIncomeFactor,
+			state.monthlyAdjustedIncome);
+	}
+
+	void AppendOrdinance(std::string& output, cISC4Ordinance& ordinance, uint32_t& onCount, uint32_t& effectPropertyCount)
+	{
+		AppendOrdinanceState(output, GetOrdinanceState(ordinance), onCount);
+
+		cISCPropertyHolder* pProperties = ordinance.GetMiscProperties();
+
+		if (pProperties)
+		{
+			EffectDumpContext context{ output, 0 };
+
+			pProperties->EnumProperties(&AppendEffectProperty, &context);
+
+			effectPropertyCount += context.propertyCount;
+		}
+	}
+
+	// The plugin's own ordinance is read through OrdinanceBase::GetState, so that the dump
+	// is not counted as calls from the game in EntryPointStatistics.
+	void AppendPluginOrdinance(std::string& output, const OrdinanceBase& ordinance, uint32_t& onCount, uint32_t& effectPropertyCount)
+	{
+		const OrdinanceBase::State state = ordinance.GetState();
+
+		AppendOrdinanceState(output, state, onCount);
+
+		state.effects->ForEachProperty([&](const cSCBaseProperty& property)
+		{
+			AppendEffect(output, property.GetPropertyID(), property.GetPropertyValue());
+			effectPropertyCount++;
+		});
+	}
+}
+
+std::string RegisteredOrdinanceDump::Format(cISC4OrdinanceSimulator& ordinanceSimulator, const OrdinanceBase& pluginOrdinance)
+{
+	std::vector<uint32_t> ordinanceIDs(InitialOrdinanceIDCapacity);
+
+	uint32_t count = static_cast<uint32_t>(ordinanceIDs.size());
+	const uint32_t totalCount = ordinanceSimulator.GetOrdinanceIDArray(ordinanceIDs.data(), count);
+
+	if (totalCount > count)
+	{
+		// The buffer is only resized when a plugin stack registers more ordinances than the initial capacity.
+		ordinanceIDs.resize(totalCount);
+
+		count = totalCount;
+		ordinanceSimulator.GetOrdinanceIDArray(ordinanceIDs.data(), count);
+	}
+
+	std::string output;
+	output.reserve(static_cast<size_t>(count) * 384);
+
+	AppendFormatted(output, "Registered ordinances: %u\n", count);
+
+	uint32_t onCount = 0;
+	uint32_t effectPropertyCount = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		cISC4Ordinance* pOrdinance = ordinanceSimulator.GetOrdinanceByID(ordinanceIDs[i]);
+
+		if (pOrdinance == &pluginOrdinance)
+		{
+			AppendPluginOrdinance(output, pluginOrdinance, onCount, effectPropertyCount);
+		}
+		else if (pOrdinance)
+		{
+			AppendOrdinance(output, *pOrdinance, onCount, effectPropertyCount);
+		}
+		else
+		{
+			AppendFormatted(output, "  0x%08x: not found\n", ordinanceIDs[i]);
+		}
+	}
+
+	AppendFormatted(
+		output,
+		"Registered ordinance totals: %u ordinances, %u on, %u effect properties\n",
+		count,
+		onCount,
+		effectPropertyCount);
+
+	return output;
+}
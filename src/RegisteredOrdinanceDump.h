@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <string>
+
+class cISC4OrdinanceSimulator;
+class OrdinanceBase;
+
+// Formats a snapshot of every ordinance that is registered with the game, for the
+// DumpRegisteredOrdinances log option.
+namespace RegisteredOrdinanceDump
+{
+	/**
+	 * @brief Formats the income fields and effect properties of the registered ordinances.
+	 * The ordinance IDs are fetched into one buffer, and the whole dump is formatted into
+	 * one string so that it can be written to the log with a single write.
+	 * @param ordinanceSimulator The ordinance simulator.
+	 * @param pluginOrdinance The ordinance that this plugin registers, it is read without
+	 * counting entry point calls.
+	 * @return The dump lines, separated by newlines.
+	*/
+	std::string Format(cISC4OrdinanceSimulator& ordinanceSimulator, const OrdinanceBase& pluginOrdinance);
+}
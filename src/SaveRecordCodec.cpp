@@ -0,0 +1,505 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "SaveRecordCodec.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include "cIGZVariant.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// The size of a value of the variant type, without the array flag.
+	// Returns zero for the pointer types that cannot be saved.
+	size_t GetVariantElementSize(uint16_t type)
+	{
+		switch (type & ~cIGZVariant::TypeArray)
+		{
+		// The base type of VoidArray, a byte array.
+		case cIGZVariant::Type::Empty:
+		case cIGZVariant::Type::Bool:
+		case cIGZVariant::Type::Uint8:
+		case cIGZVariant::Type::Sint8:
+		case cIGZVariant::Type::Char:
+		case cIGZVariant::Type::RZChar:
+			return 1;
+		case cIGZVariant::Type::Uint16:
+		case cIGZVariant::Type::Sint16:
+		case cIGZVariant::Type::RZUnicodeChar:
+			return 2;
+		case cIGZVariant::Type::Uint32:
+		case cIGZVariant::Type::Sint32:
+		case cIGZVariant::Type::Float32:
+			return 4;
+		case cIGZVariant::Type::Uint64:
+		case cIGZVariant::Type::Sint64:
+		case cIGZVariant::Type::Float64:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	const void* GetVariantArrayData(const cIGZVariant& value)
+	{
+		switch (value.GetType())
+		{
+		case cIGZVariant::Type::VoidArray: return value.RefVoid();
+		case cIGZVariant::Type::BoolArray: return value.RefBool();
+		case cIGZVariant::Type::Uint8Array: return value.RefUint8();
+		case cIGZVariant::Type::Sint8Array: return value.RefSint8();
+		case cIGZVariant::Type::Uint16Array: return value.RefUint16();
+		case cIGZVariant::Type::Sint16Array: return value.RefSint16();
+		case cIGZVariant::Type::Uint32Array: return value.RefUint32();
+		case cIGZVariant::Type::Sint32Array: return value.RefSint32();
+		case cIGZVariant::Type::Uint64Array: return value.RefUint64();
+		case cIGZVariant::Type::Sint64Array: return value.RefSint64();
+		case cIGZVariant::Type::Float32Array: return value.RefFloat32();
+		case cIGZVariant::Type::Float64Array: return value.RefFloat64();
+		case cIGZVariant::Type::CharArray: return value.RefChar();
+		case cIGZVariant::Type::RZUnicodeCharArray: return value.RefRZUnicodeChar();
+		case cIGZVariant::Type::RZCharArray: return value.RefRZChar();
+		default: return nullptr;
+		}
+	}
+
+	void SetVariantArrayData(cIGZVariant& value, uint16_t type, void* data, uint32_t count)
+	{
+		switch (type)
+		{
+		case cIGZVariant::Type::VoidArray: value.RefVoid(data, count); break;
+		case cIGZVariant::Type::BoolArray: value.RefBool(static_cast<bool*>(data), count); break;
+		case cIGZVariant::Type::Uint8Array: value.RefUint8(static_cast<uint8_t*>(data), count); break;
+		case cIGZVariant::Type::Sint8Array: value.RefSint8(static_cast<int8_t*>(data), count); break;
+		case cIGZVariant::Type::Uint16Array: value.RefUint16(static_cast<uint16_t*>(data), count); break;
+		case cIGZVariant::Type::Sint16Array: value.RefSint16(static_cast<int16_t*>(data), count); break;
+		case cIGZVariant::Type::Uint32Array: value.RefUint32(static_cast<uint32_t*>(data), count); break;
+		case cIGZVariant::Type::Sint32Array: value.RefSint32(static_cast<int32_t*>(data), count); break;
+		case cIGZVariant::Type::Uint64Array: value.RefUint64(static_cast<uint64_t*>(data), count); break;
+		case cIGZVariant::Type::Sint64Array: value.RefSint64(static_cast<int64_t*>(data), count); break;
+		case cIGZVariant::Type::Float32Array: value.RefFloat32(static_cast<float*>(data), count); break;
+		case cIGZVariant::Type::Float64Array: value.RefFloat64(static_cast<double*>(data), count); break;
+		case cIGZVariant::Type::CharArray: value.RefChar(static_cast<char*>(data), count); break;
+		case cIGZVariant::Type::RZUnicodeCharArray: value.RefRZUnicodeChar(static_cast<uint16_t*>(data), count); break;
+		case cIGZVariant::Type::RZCharArray: value.RefRZChar(static_cast<char*>(data), count); break;
+		}
+	}
+
+	template<typename T>
+	T ReadScalar(const uint8_t* data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+}
+
+SaveRecordWriter::SaveRecordWriter(uint32_t version)
+	: buffer(), length(0)
+{
+	buffer.resize(buffer.capacity(), boost::container::default_init);
+
+	WriteUint32(version);
+	// The payload size is set by WriteTo.
+	WriteUint32(0);
+}
+
+void SaveRecordWriter::WriteVarint(int64_t value)
+{
+	WriteVaruint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void SaveRecordWriter::WriteVaruint(uint64_t value)
+{
+	uint8_t bytes[10];
+	size_t length = 0;
+
+	while (value >= 0x80)
+	{
+		bytes[length++] = static_cast<uint8_t>(value | 0x80);
+		value >>= 7;
+	}
+
+	bytes[length++] = static_cast<uint8_t>(value);
+
+	WriteBytes(bytes, length);
+}
+
+bool SaveRecordWriter::WriteVariant(const cIGZVariant& value)
+{
+	const uint16_t type = value.GetType();
+
+	if (type == cIGZVariant::Type::Empty)
+	{
+		WriteUint16(type);
+		return true;
+	}
+
+	const size_t elementSize = GetVariantElementSize(type);
+
+	if (elementSize == 0)
+	{
+		return false;
+	}
+
+	WriteUint16(type);
+
+	if ((type & cIGZVariant::TypeArray) != 0)
+	{
+		const uint32_t count = value.GetCount();
+		const void* data = GetVariantArrayData(value);
+
+		if (count > 0 && !data)
+		{
+			return false;
+		}
+
+		WriteVaruint(count);
+
+		// An empty array can have a null data pointer, which memcpy does not accept.
+		if (count > 0)
+		{
+			WriteBytes(data, count * elementSize);
+		}
+
+		return true;
+	}
+
+	switch (type)
+	{
+	case cIGZVariant::Type::Bool:
+		WriteUint8(value.GetValBool() ? 1 : 0);
+		break;
+	case cIGZVariant::Type::Uint8:
+		WriteUint8(value.GetValUint8());
+		break;
+	case cIGZVariant::Type::Sint8:
+		WriteUint8(static_cast<uint8_t>(value.GetValSint8()));
+		break;
+	case cIGZVariant::Type::Uint16:
+		WriteUint16(value.GetValUint16());
+		break;
+	case cIGZVariant::Type::Sint16:
+		WriteUint16(static_cast<uint16_t>(value.GetValSint16()));
+		break;
+	case cIGZVariant::Type::Uint32:
+		WriteUint32(value.GetValUint32());
+		break;
+	case cIGZVariant::Type::Sint32:
+		WriteUint32(static_cast<uint32_t>(value.GetValSint32()));
+		break;
+	case cIGZVariant::Type::Uint64:
+	{
+		const uint64_t uint64Value = value.GetValUint64();
+		WriteBytes(&uint64Value, sizeof(uint64Value));
+		break;
+	}
+	case cIGZVariant::Type::Sint64:
+	{
+		const int64_t sint64Value = value.GetValSint64();
+		WriteBytes(&sint64Value, sizeof(sint64Value));
+		break;
+	}
+	case cIGZVariant::Type::Float32:
+		WriteFloat32(value.GetValFloat32());
+		break;
+	case cIGZVariant::Type::Float64:
+	{
+		const double float64Value = value.GetValFloat64();
+		WriteBytes(&float64Value, sizeof(float64Value));
+		break;
+	}
+	case cIGZVariant::Type::Char:
+		WriteUint8(static_cast<uint8_t>(value.GetValChar()));
+		break;
+	case cIGZVariant::Type::RZUnicodeChar:
+		WriteUint16(value.GetValRZUnicodeChar());
+		break;
+	case cIGZVariant::Type::RZChar:
+		WriteUint8(static_cast<uint8_t>(value.GetValRZChar()));
+		break;
+	}
+
+	return true;
+}
+
+size_t SaveRecordWriter::BeginSection(uint16_t tag)
+{
+	WriteUint16(tag);
+
+	// The size is set by EndSection.
+	const size_t section = length;
+	WriteUint32(0);
+
+	return section;
+}
+
+void SaveRecordWriter::EndSection(size_t section)
+{
+	const uint32_t sectionSize = static_cast<uint32_t>(length - section - sizeof(uint32_t));
+	std::memcpy(buffer.data() + section, &sectionSize, sizeof(sectionSize));
+}
+
+bool SaveRecordWriter::WriteTo(cIGZOStream& stream)
+{
+	const uint32_t payloadSize = static_cast<uint32_t>(length - HeaderSize);
+	std::memcpy(buffer.data() + 4, &payloadSize, sizeof(payloadSize));
+
+	return stream.SetVoid(buffer.data(), static_cast<uint32_t>(length));
+}
+
+const uint8_t* SaveRecordWriter::Data() const
+{
+	return buffer.data();
+}
+
+size_t SaveRecordWriter::Size() const
+{
+	return length;
+}
+
+void SaveRecordWriter::Grow(size_t requiredSize)
+{
+	buffer.resize(std::max(requiredSize, buffer.size() * 2), boost::container::default_init);
+}
+
+SaveRecordReader::SaveRecordReader()
+	: storage(), data(nullptr), size(0), position(0), error(false)
+{
+}
+
+SaveRecordReader::SaveRecordReader(const void* data, size_t size)
+	: storage(), data(static_cast<const uint8_t*>(data)), size(size), position(0), error(false)
+{
+}
+
+bool SaveRecordReader::ReadFrom(cIGZIStream& stream)
+{
+	uint32_t payloadSize = 0;
+
+	if (!stream.GetUint32(payloadSize) || payloadSize > MaxPayloadSize)
+	{
+		return Fail();
+	}
+
+	storage.resize(payloadSize);
+
+	if (payloadSize > 0 && !stream.GetVoid(storage.data(), payloadSize))
+	{
+		return Fail();
+	}
+
+	data = storage.data();
+	size = payloadSize;
+	position = 0;
+	error = false;
+
+	return true;
+}
+
+bool SaveRecordReader::ReadVarint(int64_t& value)
+{
+	uint64_t encoded = 0;
+
+	if (!ReadVaruint(encoded))
+	{
+		return false;
+	}
+
+	value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+	return true;
+}
+
+bool SaveRecordReader::ReadVaruint(uint64_t& value)
+{
+	uint64_t result = 0;
+
+	for (uint32_t shift = 0; shift < 64; shift += 7)
+	{
+		if (error || position >= size)
+		{
+			return Fail();
+		}
+
+		const uint8_t byte = data[position++];
+		result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			value = result;
+			return true;
+		}
+	}
+
+	// The value is longer than the 10 bytes that a 64-bit integer can use.
+	return Fail();
+}
+
+bool SaveRecordReader::ReadVariant(cIGZVariant& value)
+{
+	uint16_t type = 0;
+
+	if (!ReadUint16(type))
+	{
+		return false;
+	}
+
+	if (type == cIGZVariant::Type::Empty)
+	{
+		return value.Erase();
+	}
+
+	const size_t elementSize = GetVariantElementSize(type);
+
+	if (elementSize == 0)
+	{
+		return Fail();
+	}
+
+	if ((type & cIGZVariant::TypeArray) != 0)
+	{
+		uint64_t count = 0;
+
+		if (!ReadVaruint(count))
+		{
+			return false;
+		}
+
+		if (count > GetRemainingSize() / elementSize)
+		{
+			return Fail();
+		}
+
+		const size_t dataSize = static_cast<size_t>(count) * elementSize;
+
+		// The array is copied to an aligned buffer, the record data has no alignment.
+		boost::container::small_vector<uint64_t, 8> elements((dataSize + 7) / 8);
+
+		if (!ReadBytes(elements.data(), dataSize))
+		{
+			return false;
+		}
+
+		if (type == cIGZVariant::Type::BoolArray)
+		{
+			uint8_t* bytes = reinterpret_cast<uint8_t*>(elements.data());
+
+			for (size_t i = 0; i < dataSize; i++)
+			{
+				bytes[i] = bytes[i] != 0 ? 1 : 0;
+			}
+		}
+
+		SetVariantArrayData(value, type, elements.data(), static_cast<uint32_t>(count));
+		return true;
+	}
+
+	uint8_t bytes[8]{};
+
+	if (!ReadBytes(bytes, elementSize))
+	{
+		return false;
+	}
+
+	switch (type)
+	{
+	case cIGZVariant::Type::Bool:
+		value.SetValBool(bytes[0] != 0);
+		break;
+	case cIGZVariant::Type::Uint8:
+		value.SetValUint8(bytes[0]);
+		break;
+	case cIGZVariant::Type::Sint8:
+		value.SetValSint8(static_cast<int8_t>(bytes[0]));
+		break;
+	case cIGZVariant::Type::Uint16:
+		value.SetValUint16(ReadScalar<uint16_t>(bytes));
+		break;
+	case cIGZVariant::Type::Sint16:
+		value.SetValSint16(ReadScalar<int16_t>(bytes));
+		break;
+	case cIGZVariant::Type::Uint32:
+		value.SetValUint32(ReadScalar<uint32_t>(bytes));
+		break;
+	case cIGZVariant::Type::Sint32:
+		value.SetValSint32(ReadScalar<int32_t>(bytes));
+		break;
+	case cIGZVariant::Type::Uint64:
+		value.SetValUint64(ReadScalar<uint64_t>(bytes));
+		break;
+	case cIGZVariant::Type::Sint64:
+		value.SetValSint64(ReadScalar<int64_t>(bytes));
+		break;
+	case cIGZVariant::Type::Float32:
+		value.SetValFloat32(ReadScalar<float>(bytes));
+		break;
+	case cIGZVariant::Type::Float64:
+		value.SetValFloat64(ReadScalar<double>(bytes));
+		break;
+	case cIGZVariant::Type::Char:
+		value.SetValChar(static_cast<char>(bytes[0]));
+		break;
+	case cIGZVariant::Type::RZUnicodeChar:
+		value.SetValRZUnicodeChar(ReadScalar<uint16_t>(bytes));
+		break;
+	case cIGZVariant::Type::RZChar:
+		value.SetValRZChar(static_cast<char>(bytes[0]));
+		break;
+	default:
+		return Fail();
+	}
+
+	return true;
+}
+
+bool SaveRecordReader::ReadSection(uint16_t& tag, SaveRecordReader& section)
+{
+	uint32_t sectionSize = 0;
+
+	if (!ReadUint16(tag) || !ReadUint32(sectionSize))
+	{
+		return false;
+	}
+
+	if (sectionSize > GetRemainingSize())
+	{
+		return Fail();
+	}
+
+	// The section reader refers to the payload of this reader, skipping a
+	// section does not copy or decode it.
+	section.storage.clear();
+	section.data = data + position;
+	section.size = sectionSize;
+	section.position = 0;
+	section.error = false;
+
+	position += sectionSize;
+	return true;
+}
+
+size_t SaveRecordReader::GetRemainingSize() const
+{
+	return size - position;
+}
+
+bool SaveRecordReader::HasError() const
+{
+	return error;
+}
+
+bool SaveRecordReader::Fail()
+{
+	error = true;
+	return false;
+}
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "boost/container/small_vector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class cIGZIStream;
+class cIGZOStream;
+class cIGZVariant;
+
+// The ordinance save records are encoded into a memory buffer and written to the
+// game's stream with one SetVoid call, instead of one virtual stream call for each
+// field. A record is a 32-bit version and a 32-bit payload size followed by the
+// payload bytes.
+//
+// The fixed size values are stored in the byte order of the machine, the game
+// streams are little-endian. Signed integers are stored as zigzag encoded LEB128
+// varints. A variant is stored as its 16-bit type, followed by the value for the
+// scalar types or a varint element count and the elements for the array types.
+//
+// The payload of a tagged record is a sequence of sections, each section is a
+// 16-bit tag and a 32-bit size followed by the section data. Readers skip the
+// sections that they do not know and ignore any data after the fields that they
+// know at the end of a section, so a newer version can add sections and append
+// fields to a section without breaking the readers of the older versions.
+class SaveRecordWriter
+{
+public:
+
+	/**
+	 * @brief Starts a record.
+	 * @param version The record version.
+	*/
+	explicit SaveRecordWriter(uint32_t version);
+
+	void WriteUint8(uint8_t value) { WriteBytes(&value, sizeof(value)); }
+	void WriteUint16(uint16_t value) { WriteBytes(&value, sizeof(value)); }
+	void WriteUint32(uint32_t value) { WriteBytes(&value, sizeof(value)); }
+	void WriteFloat32(float value) { WriteBytes(&value, sizeof(value)); }
+	void WriteVarint(int64_t value);
+	void WriteVaruint(uint64_t value);
+
+	void WriteBytes(const void* data, size_t size)
+	{
+		if (length + size > buffer.size())
+		{
+			Grow(length + size);
+		}
+
+		std::memcpy(buffer.data() + length, data, size);
+		length += size;
+	}
+
+	/**
+	 * @brief Writes a variant value.
+	 * @param value The value.
+	 * @return True if the value was written; otherwise, false if the variant
+	 * contains a pointer type that cannot be saved.
+	*/
+	bool WriteVariant(const cIGZVariant& value);
+
+	/**
+	 * @brief Starts a tagged section, the following values are the section data.
+	 * @param tag The section tag.
+	 * @return The position of the section, which is passed to EndSection.
+	*/
+	size_t BeginSection(uint16_t tag);
+
+	/**
+	 * @brief Sets the size of a section after its data has been written.
+	 * @param section The section position that BeginSection returned.
+	*/
+	void EndSection(size_t section);
+
+	/**
+	 * @brief Sets the payload size and writes the record to the stream.
+	 * @param stream The stream.
+	 * @return True if the record was written; otherwise, false.
+	*/
+	bool WriteTo(cIGZOStream& stream);
+
+	const uint8_t* Data() const;
+	size_t Size() const;
+
+	// The size of the version and payload size fields at the start of the record.
+	static constexpr size_t HeaderSize = 8;
+
+private:
+
+	void Grow(size_t requiredSize);
+
+	// The lottery ordinance record is about 70 bytes, most records fit in the inline buffer.
+	// The buffer size is its capacity, the record is the first length bytes.
+	boost::container::small_vector<uint8_t, 256> buffer;
+	size_t length;
+};
+
+// Decodes a record payload, every read is checked against the end of the payload.
+// A failed read sets the error state and the following reads also fail.
+class SaveRecordReader
+{
+public:
+
+	SaveRecordReader();
+
+	/**
+	 * @brief Decodes a payload that is already in memory.
+	 * @param data The payload data, it must outlive the reader.
+	 * @param size The payload size.
+	*/
+	SaveRecordReader(const void* data, size_t size);
+
+	SaveRecordReader(const SaveRecordReader&) = delete;
+	SaveRecordReader& operator=(const SaveRecordReader&) = delete;
+
+	/**
+	 * @brief Reads the payload size and the payload of a record from the stream,
+	 * the caller has already read the record version.
+	 * @param stream The stream.
+	 * @return True if the payload was read; otherwise, false.
+	*/
+	bool ReadFrom(cIGZIStream& stream);
+
+	bool ReadUint8(uint8_t& value) { return ReadBytes(&value, sizeof(value)); }
+	bool ReadUint16(uint16_t& value) { return ReadBytes(&value, sizeof(value)); }
+	bool ReadUint32(uint32_t& value) { return ReadBytes(&value, sizeof(value)); }
+	bool ReadFloat32(float& value) { return ReadBytes(&value, sizeof(value)); }
+	bool ReadVarint(int64_t& value);
+	bool ReadVaruint(uint64_t& value);
+
+	bool ReadBytes(void* output, size_t outputSize)
+	{
+		if (error || outputSize > size - position)
+		{
+			return Fail();
+		}
+
+		std::memcpy(output, data + position, outputSize);
+		position += outputSize;
+		return true;
+	}
+
+	/**
+	 * @brief Reads a variant value that was written by SaveRecordWriter::WriteVariant.
+	 * @param value Receives the value.
+	 * @return True if the value was read; otherwise, false.
+	*/
+	bool ReadVariant(cIGZVariant& value);
+
+	/**
+	 * @brief Reads the tag and size of the next section and moves past the section data.
+	 * @param tag Receives the section tag.
+	 * @param section Receives a reader for the section data, it must not outlive this reader.
+	 * @return True if the section was read; otherwise, false.
+	*/
+	bool ReadSection(uint16_t& tag, SaveRecordReader& section);
+
+	size_t GetRemainingSize() const;
+	bool HasError() const;
+
+	// The payload size limit of ReadFrom, larger sizes are treated as a corrupt record.
+	static constexpr uint32_t MaxPayloadSize = 1024 * 1024;
+
+private:
+
+	bool Fail();
+
+	boost::container::small_vector<uint8_t, 256> storage;
+	const uint8_t* data;
+	size_t size;
+	size_t position;
+	bool error;
+};
@@ -12,11 +12,38 @@
 
 #include "Settings.h"
 #include "Logger.h"
+#include "TraceEventRecorder.h"
 #include "boost/property_tree/ptree.hpp"
 #include "boost/property_tree/ini_parser.hpp"
+#include <array>
 
 namespace
 {
+	struct PopulationIncomeFactorKey
+	{
+		const char* name;
+		uint32_t demandGroupID;
+		bool required;
+	};
+
+	// The residential keys are present in every version of the INI file,
+	// the other census groups are optional and default to 0.0.
+	constexpr std::array<PopulationIncomeFactorKey, 12> PopulationIncomeFactorKeys =
+	{
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.R$IncomeFactor", CensusGroupID::ResidentialLowWealth, true },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.R$$IncomeFactor", CensusGroupID::ResidentialMedWealth, true },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.R$$$IncomeFactor", CensusGroupID::ResidentialHighWealth, true },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.Cs$IncomeFactor", CensusGroupID::CommercialServiceLowWealth, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.Cs$$IncomeFactor", CensusGroupID::CommercialServiceMedWealth, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.Cs$$$IncomeFactor", CensusGroupID::CommercialServiceHighWealth, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.Co$$IncomeFactor", CensusGroupID::CommercialOfficeMedWealth, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.Co$$$IncomeFactor", CensusGroupID::CommercialOfficeHighWealth, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.I-RIncomeFactor", CensusGroupID::IndustrialAgriculture, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.I-DIncomeFactor", CensusGroupID::IndustrialDirty, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.I-MIncomeFactor", CensusGroupID::IndustrialManufacturing, false },
+		PopulationIncomeFactorKey{ "CityLotteryOrdinance.I-HTIncomeFactor", CensusGroupID::IndustrialHighTech, false },
+	};
+
 	// Throws an exception of the value is out of range.
 	float CheckValueRange(float value, float min, float max, const char* name)
 	{
@@ -53,15 +80,20 @@ namespace
 
 Settings::Settings()
 	: monthlyConstantIncome(500),
-	  residentialLowWealthFactor(0.05f),
-	  residentialMedWealthFactor(0.03f),
-	  residentialHighWealthFactor(0.01f),
-	  cityLotteryOrdinanceEffects()
+	  populationIncomeFactors(
+		  {
+			  PopulationIncomeFactor{ CensusGroupID::ResidentialLowWealth, 0.05f },
+			  PopulationIncomeFactor{ CensusGroupID::ResidentialMedWealth, 0.03f },
+			  PopulationIncomeFactor{ CensusGroupID::ResidentialHighWealth, 0.01f },
+		  }),
+	  cityLotteryOrdinanceEffects(OrdinancePropertyHolder::DuplicatePropertyMode::Replace)
 {
 }
 
 void Settings::Load(const std::filesystem::path& path)
 {
+	TraceEventScope traceScope("Settings::Load");
+
 	std::ifstream stream(path, std::ifstream::in);
 
 	if (!stream)
@@ -74,9 +106,20 @@ void Settings::Load(const std::filesystem::path& path)
 	boost::property_tree::ini_parser::read_ini(stream, tree);
 
 	monthlyConstantIncome = tree.get<int64_t>("CityLotteryOrdinance.MonthlyConstantIncome");
-	residentialLowWealthFactor = tree.get<float>("CityLotteryOrdinance.R$IncomeFactor");
-	residentialMedWealthFactor = tree.get<float>("CityLotteryOrdinance.R$$IncomeFactor");
-	residentialHighWealthFactor = tree.get<float>("CityLotteryOrdinance.R$$$IncomeFactor");
+
+	// Groups with a factor of 0.0 or less do not participate in the city lottery,
+	// they are removed here so that the income calculation does not have to check them.
+	populationIncomeFactors.clear();
+
+	for (const PopulationIncomeFactorKey& key : PopulationIncomeFactorKeys)
+	{
+		const float factor = key.required ? tree.get<float>(key.name) : tree.get<float>(key.name, 0.0f);
+
+		if (factor > 0.0f)
+		{
+			populationIncomeFactors.push_back(PopulationIncomeFactor{ key.demandGroupID, factor });
+		}
+	}
 
 	float crimeEffectMultiplier = CheckValueRange(
 		tree.get<float>("CityLotteryOrdinance.CrimeEffectMultiplier"),
@@ -96,7 +139,7 @@ void Settings::Load(const std::filesystem::path& path)
 		200,
 		"SchoolEQBoostEffect");
 
-	cityLotteryOrdinanceEffects.RemoveAllProperties();
+	cityLotteryOrdinanceEffects = OrdinancePropertyHolder(OrdinancePropertyHolder::DuplicatePropertyMode::Replace);
 
 	if (crimeEffectMultiplier != 1.0f)
 	{
@@ -119,19 +162,9 @@ int64_t Settings::MonthlyConstantIncome() const
 	return monthlyConstantIncome;
 }
 
-float Settings::ResidentialLowWealthFactor() const
-{
-	return residentialLowWealthFactor;
-}
-
-float Settings::ResidentialMedWealthFactor() const
-{
-	return residentialMedWealthFactor;
-}
-
-float Settings::ResidentialHighWealthFactor() const
+const std::vector<PopulationIncomeFactor>& Settings::PopulationIncomeFactors() const
 {
-	return residentialHighWealthFactor;
+	return populationIncomeFactors;
 }
 
 OrdinancePropertyHolder Settings::OrdinanceEffects() const
@@ -25,18 +25,14 @@ public:
 	// Inherited via ISettings
 
 	int64_t MonthlyConstantIncome() const override;
-	float ResidentialLowWealthFactor() const override;
-	float ResidentialMedWealthFactor() const override;
-	float ResidentialHighWealthFactor() const override;
+	const std::vector<PopulationIncomeFactor>& PopulationIncomeFactors() const override;
 	OrdinancePropertyHolder OrdinanceEffects() const override;
 
 
 private:
 
 	int64_t monthlyConstantIncome;
-	float residentialLowWealthFactor;
-	float residentialMedWealthFactor;
-	float residentialHighWealthFactor;
+	std::vector<PopulationIncomeFactor> populationIncomeFactors;
 	OrdinancePropertyHolder cityLotteryOrdinanceEffects;
 };
 
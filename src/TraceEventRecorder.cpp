@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "TraceEventRecorder.h"
+#include "Logger.h"
+#include <cinttypes>
+#include <cstdio>
+
+namespace
+{
+	// 64K spans use 2 MB, which is about 10000 months of Simulate and budget window calls.
+	constexpr size_t SpanBufferCapacity = 65536;
+
+	constexpr const char* ProcessMetadataEvent =
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"SC4CityLotteryOrdinance\"}}";
+}
+
+TraceEventRecorder& TraceEventRecorder::GetInstance()
+{
+	static TraceEventRecorder instance;
+
+	return instance;
+}
+
+TraceEventRecorder::TraceEventRecorder()
+	: file(),
+	  spans(),
+	  output(),
+	  startTimestamp(0),
+	  simMonth(0),
+	  citySerialNumber(0)
+{
+}
+
+TraceEventRecorder::~TraceEventRecorder()
+{
+	Close();
+}
+
+bool TraceEventRecorder::Open(const std::filesystem::path& path)
+{
+	if (isRecording)
+	{
+		return true;
+	}
+
+	file.open(path, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+	if (!file)
+	{
+		Logger::GetInstance().WriteLine(LogOptions::Errors, "Failed to create the trace event file.");
+		return false;
+	}
+
+	// The JSON array format is used, the closing bracket is optional so a trace
+	// from a session that did not shut down cleanly can still be loaded.
+	file << "[\n" << ProcessMetadataEvent;
+
+	spans.reserve(SpanBufferCapacity);
+	startTimestamp = GetTimestamp();
+	isRecording = true;
+
+	return true;
+}
+
+void TraceEventRecorder::Close()
+{
+	if (isRecording)
+	{
+		Flush();
+
+		file << "\n]\n";
+		file.close();
+
+		spans.clear();
+		spans.shrink_to_fit();
+		output.clear();
+		output.shrink_to_fit();
+		isRecording = false;
+	}
+}
+
+void TraceEventRecorder::SetCitySerialNumber(uint32_t citySerialNumber)
+{
+	this->citySerialNumber = citySerialNumber;
+}
+
+void TraceEventRecorder::SetSimMonth(uint32_t simMonth)
+{
+	this->simMonth = simMonth;
+}
+
+void TraceEventRecorder::AddSpan(const char* name, uint64_t start, uint64_t end)
+{
+	if (!isRecording)
+	{
+		return;
+	}
+
+	if (spans.size() == spans.capacity())
+	{
+		const uint64_t flushStart = GetTimestamp();
+
+		Flush();
+
+		spans.push_back(Span{ "TraceEventRecorder::Flush", flushStart, GetTimestamp() - flushStart, simMonth, citySerialNumber });
+	}
+
+	spans.push_back(Span{ name, start, end - start, simMonth, citySerialNumber });
+}
+
+void TraceEventRecorder::Flush()
+{
+	if (!isRecording || spans.empty())
+	{
+		return;
+	}
+
+	// Each span is about 150 bytes of JSON, the spans are formatted into one
+	// string so that the file is written in a single call.
+	output.clear();
+	output.reserve(spans.size() * 160);
+
+	for (const Span& span : spans)
+	{
+		AppendSpan(output, span);
+	}
+
+	file.write(output.data(), static_cast<std::streamsize>(output.size()));
+	file.flush();
+
+	spans.clear();
+}
+
+void TraceEventRecorder::AppendSpan(std::string& output, const Span& span) const
+{
+	// The trace event timestamps are in microseconds, relative to the start of the trace.
+	const uint64_t start = span.start - startTimestamp;
+
+	char buffer[384]{};
+
+	int length = std::snprintf(
+		buffer,
+		sizeof(buffer),
+		",\n{\"name\":\"%s\",\"cat\":\"ordinance\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+		"\"ts\":%" PRIu64 ".%03" PRIu64 ",\"dur\":%" PRIu64 ".%03" PRIu64,
+		span.name,
+		start / 1000,
+		start % 1000,
+		span.duration / 1000,
+		span.duration % 1000);
+
+	if (span.simMonth != 0)
+	{
+		// The sim month is year * 12 + month, where the month is in the range [1, 12].
+		const uint32_t year = (span.simMonth - 1) / 12;
+		const uint32_t month = ((span.simMonth - 1) % 12) + 1;
+
+		length += std::snprintf(
+			buffer + length,
+			sizeof(buffer) - length,
+			",\"args\":{\"simDate\":\"%04u-%02u\",\"city\":%u}}",
+			year,
+			month,
+			span.citySerialNumber);
+	}
+	else
+	{
+		length += std::snprintf(buffer + length, sizeof(buffer) - length, "}");
+	}
+
+	output.append(buffer, static_cast<size_t>(length));
+}
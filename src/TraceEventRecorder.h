@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Records spans of the ordinance callbacks and writes them as Chrome trace-event
+// JSON, which can be opened in Perfetto or chrome://tracing.
+//
+// The spans are buffered in memory and written to the file when the city is
+// shut down, so that the file I/O is not included in the measured callbacks.
+// If the buffer fills up during a session it is written early, and the time
+// that took is recorded as a TraceEventRecorder::Flush span.
+// The recorder is used from the game's main thread.
+class TraceEventRecorder
+{
+public:
+
+	static TraceEventRecorder& GetInstance();
+
+	TraceEventRecorder(const TraceEventRecorder&) = delete;
+	TraceEventRecorder& operator=(const TraceEventRecorder&) = delete;
+
+	/**
+	 * @brief Creates the trace file and starts recording.
+	 * @param path The trace file path.
+	 * @return True if the file was created; otherwise, false.
+	*/
+	bool Open(const std::filesystem::path& path);
+
+	/**
+	 * @brief Writes the buffered spans and closes the trace file.
+	*/
+	void Close();
+
+	/**
+	 * @brief Determines if the recorder is open, this is checked before each span.
+	 * @return True if the recorder is open; otherwise, false.
+	*/
+	static bool IsRecording()
+	{
+		return isRecording;
+	}
+
+	/**
+	 * @brief Sets the city serial number that the following spans are tagged with.
+	 * @param citySerialNumber The city serial number, or 0 when no city is loaded.
+	*/
+	void SetCitySerialNumber(uint32_t citySerialNumber);
+
+	/**
+	 * @brief Sets the sim date that the following spans are tagged with.
+	 * @param simMonth The sim month, year * 12 + month, or 0 when no city is loaded.
+	*/
+	void SetSimMonth(uint32_t simMonth);
+
+	static uint64_t GetTimestamp()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	/**
+	 * @brief Adds a span to the buffer.
+	 * @param name The span name, this must be a string literal.
+	 * @param start The start timestamp from GetTimestamp.
+	 * @param end The end timestamp from GetTimestamp.
+	*/
+	void AddSpan(const char* name, uint64_t start, uint64_t end);
+
+	/**
+	 * @brief Writes the buffered spans to the trace file.
+	*/
+	void Flush();
+
+private:
+
+	struct Span
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t duration;
+		uint32_t simMonth;
+		uint32_t citySerialNumber;
+	};
+
+	TraceEventRecorder();
+	~TraceEventRecorder();
+
+	void AppendSpan(std::string& output, const Span& span) const;
+
+	std::ofstream file;
+	std::vector<Span> spans;
+	std::string output;
+	uint64_t startTimestamp;
+	uint32_t simMonth;
+	uint32_t citySerialNumber;
+
+	static inline bool isRecording = false;
+};
+
+// Records a span from its construction to its destruction when the trace recorder is open.
+class TraceEventScope
+{
+public:
+
+	explicit TraceEventScope(const char* name)
+		: name(name), start(0)
+	{
+		if (TraceEventRecorder::IsRecording())
+		{
+			start = TraceEventRecorder::GetTimestamp();
+		}
+	}
+
+	~TraceEventScope()
+	{
+		if (start != 0)
+		{
+			TraceEventRecorder::GetInstance().AddSpan(name, start, TraceEventRecorder::GetTimestamp());
+		}
+	}
+
+	TraceEventScope(const TraceEventScope&) = delete;
+	TraceEventScope& operator=(const TraceEventScope&) = delete;
+
+private:
+
+	const char* name;
+	uint64_t start;
+};
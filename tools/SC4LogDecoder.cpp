@@ -0,0 +1,498 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-city-lottery-ordinance, a DLL Plugin for
+// SimCity 4 that adds a city lottery to the game.
+//
+// Copyright (c) 2023 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Expands a binary trace log that was written with LogWriteMode::BinaryTrace
+// back to the text log format, or to CSV.
+
+#include "BinaryTraceFormat.h"
+#include <bit>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using BinaryTraceFormat::ArgumentType;
+using BinaryTraceFormat::RecordType;
+
+namespace
+{
+	enum class OutputFormat
+	{
+		Text,
+		Csv
+	};
+
+	struct DecoderOptions
+	{
+		OutputFormat outputFormat = OutputFormat::Text;
+		std::filesystem::path inputPath;
+		std::filesystem::path outputPath;
+	};
+
+	struct FormatInfo
+	{
+		std::string text;
+		std::vector<BinaryTraceFormat::FormatArgument> arguments;
+	};
+
+	struct DecoderState
+	{
+		std::unordered_map<uint64_t, FormatInfo> formats;
+		std::unordered_map<uint64_t, std::string> strings;
+		uint64_t startMilliseconds = 0;
+		uint64_t elapsedMicroseconds = 0;
+		uint64_t simMonth = 0;
+	};
+
+	void PrintUsage(const char* programName)
+	{
+		std::printf(
+			"Usage: %s [options] <trace file>\n"
+			"  --csv               Write CSV instead of the text log format.\n"
+			"  --output <path>     The output file, defaults to the standard output.\n",
+			programName);
+	}
+
+	bool ParseOptions(int argc, char** argv, DecoderOptions& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* arg = argv[i];
+
+			if (std::strcmp(arg, "--help") == 0)
+			{
+				return false;
+			}
+			else if (std::strcmp(arg, "--csv") == 0)
+			{
+				options.outputFormat = OutputFormat::Csv;
+			}
+			else if (std::strcmp(arg, "--output") == 0)
+			{
+				if (i + 1 >= argc)
+				{
+					std::fprintf(stderr, "Missing value for %s.\n", arg);
+					return false;
+				}
+
+				options.outputPath = argv[++i];
+			}
+			else if (options.inputPath.empty())
+			{
+				options.inputPath = arg;
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option: %s\n", arg);
+				return false;
+			}
+		}
+
+		return !options.inputPath.empty();
+	}
+
+	template <typename... Args>
+	void AppendFormatted(std::string& output, const char* format, Args... args)
+	{
+		const int length = std::snprintf(nullptr, 0, format, args...);
+
+		if (length > 0)
+		{
+			const size_t offset = output.size();
+
+			output.resize(offset + static_cast<size_t>(length) + 1);
+			std::snprintf(output.data() + offset, static_cast<size_t>(length) + 1, format, args...);
+			output.resize(offset + static_cast<size_t>(length));
+		}
+	}
+
+	bool ReadText(const uint8_t*& input, const uint8_t* end, std::string& text)
+	{
+		uint64_t length = 0;
+
+		if (!BinaryTraceFormat::ReadVarint(input, end, length) || length > static_cast<uint64_t>(end - input))
+		{
+			return false;
+		}
+
+		text.assign(reinterpret_cast<const char*>(input), static_cast<size_t>(length));
+		input += length;
+
+		return true;
+	}
+
+	bool ReadUInt16(const uint8_t*& input, const uint8_t* end, uint16_t& value)
+	{
+		if (end - input < 2)
+		{
+			return false;
+		}
+
+		value = static_cast<uint16_t>(input[0] | (input[1] << 8));
+		input += 2;
+
+		return true;
+	}
+
+	// Formats an Entry record by passing each conversion specifier and its
+	// argument to snprintf with the argument's original C type.
+	bool FormatEntry(
+		const FormatInfo& format,
+		const DecoderState& state,
+		const uint8_t*& input,
+		const uint8_t* end,
+		std::string& message)
+	{
+		size_t segmentStart = 0;
+		std::string segment;
+
+		for (const BinaryTraceFormat::FormatArgument& argument : format.arguments)
+		{
+			segment.assign(format.text, segmentStart, argument.end - segmentStart);
+			segmentStart = argument.end;
+
+			uint64_t value = 0;
+
+			if (argument.type == ArgumentType::Double)
+			{
+				if (end - input < 8)
+				{
+					return false;
+				}
+
+				for (int shift = 0; shift < 64; shift += 8)
+				{
+					value |= static_cast<uint64_t>(*input++) << shift;
+				}
+			}
+			else if (!BinaryTraceFormat::ReadVarint(input, end, value))
+			{
+				return false;
+			}
+
+			const int64_t signedValue = BinaryTraceFormat::ZigZagDecode(value);
+
+			switch (argument.type)
+			{
+			case ArgumentType::Int:
+				AppendFormatted(message, segment.c_str(), static_cast<int>(signedValue));
+				break;
+			case ArgumentType::Long:
+				AppendFormatted(message, segment.c_str(), static_cast<long>(signedValue));
+				break;
+			case ArgumentType::LongLong:
+				AppendFormatted(message, segment.c_str(), static_cast<long long>(signedValue));
+				break;
+			case ArgumentType::IntMax:
+				AppendFormatted(message, segment.c_str(), static_cast<intmax_t>(signedValue));
+				break;
+			case ArgumentType::PtrDiff:
+				AppendFormatted(message, segment.c_str(), static_cast<ptrdiff_t>(signedValue));
+				break;
+			case ArgumentType::UnsignedInt:
+				AppendFormatted(message, segment.c_str(), static_cast<unsigned int>(value));
+				break;
+			case ArgumentType::UnsignedLong:
+				AppendFormatted(message, segment.c_str(), static_cast<unsigned long>(value));
+				break;
+			case ArgumentType::UnsignedLongLong:
+				AppendFormatted(message, segment.c_str(), static_cast<unsigned long long>(value));
+				break;
+			case ArgumentType::UIntMax:
+				AppendFormatted(message, segment.c_str(), static_cast<uintmax_t>(value));
+				break;
+			case ArgumentType::Size:
+				AppendFormatted(message, segment.c_str(), static_cast<size_t>(value));
+				break;
+			case ArgumentType::Double:
+				AppendFormatted(message, segment.c_str(), std::bit_cast<double>(value));
+				break;
+			case ArgumentType::String:
+			{
+				auto it = state.strings.find(value);
+
+				if (it == state.strings.end())
+				{
+					return false;
+				}
+
+				AppendFormatted(message, segment.c_str(), it->second.c_str());
+				break;
+			}
+			case ArgumentType::Pointer:
+				AppendFormatted(message, segment.c_str(), reinterpret_cast<void*>(static_cast<uintptr_t>(value)));
+				break;
+			}
+		}
+
+		if (segmentStart < format.text.size())
+		{
+			segment.assign(format.text, segmentStart);
+			AppendFormatted(message, segment.c_str());
+		}
+
+		return true;
+	}
+
+	void AppendCsvField(std::string& output, const std::string& value)
+	{
+		output.push_back('"');
+
+		for (char c : value)
+		{
+			if (c == '"')
+			{
+				output.push_back('"');
+			}
+
+			output.push_back(c);
+		}
+
+		output.push_back('"');
+	}
+
+	void WriteLine(
+		std::FILE* output,
+		OutputFormat outputFormat,
+		const DecoderState& state,
+		bool hasTimestamp,
+		int64_t callSiteID,
+		const std::string& message)
+	{
+		std::string line;
+
+		const uint64_t milliseconds = (state.startMilliseconds + (state.elapsedMicroseconds / 1000)) % (24 * 60 * 60 * 1000);
+		const unsigned int hour = static_cast<unsigned int>(milliseconds / (60 * 60 * 1000));
+		const unsigned int minute = static_cast<unsigned int>((milliseconds / (60 * 1000)) % 60);
+		const unsigned int second = static_cast<unsigned int>((milliseconds / 1000) % 60);
+		const unsigned int millisecond = static_cast<unsigned int>(milliseconds % 1000);
+
+		if (outputFormat == OutputFormat::Text)
+		{
+			if (hasTimestamp)
+			{
+				AppendFormatted(line, "[%u:%u:%u.%u] ", hour, minute, second, millisecond);
+			}
+
+			line.append(message);
+		}
+		else
+		{
+			if (hasTimestamp)
+			{
+				AppendFormatted(
+					line,
+					"%llu,%u:%02u:%02u.%03u,%llu,",
+					static_cast<unsigned long long>(state.elapsedMicroseconds),
+					hour,
+					minute,
+					second,
+					millisecond,
+					static_cast<unsigned long long>(state.simMonth));
+			}
+			else
+			{
+				line.append(",,,");
+			}
+
+			if (callSiteID >= 0)
+			{
+				AppendFormatted(line, "%lld", static_cast<long long>(callSiteID));
+			}
+
+			line.push_back(',');
+			AppendCsvField(line, message);
+		}
+
+		line.push_back('\n');
+		std::fwrite(line.data(), 1, line.size(), output);
+	}
+
+	bool Decode(const std::vector<uint8_t>& trace, std::FILE* output, OutputFormat outputFormat)
+	{
+		const uint8_t* input = trace.data();
+		const uint8_t* const end = input + trace.size();
+
+		if (trace.size() < BinaryTraceFormat::FileHeaderSize
+			|| std::memcmp(input, BinaryTraceFormat::Magic, sizeof(BinaryTraceFormat::Magic)) != 0)
+		{
+			std::fprintf(stderr, "The file is not a binary trace log.\n");
+			return false;
+		}
+
+		input += sizeof(BinaryTraceFormat::Magic);
+
+		uint16_t version = 0;
+		uint16_t hour = 0;
+		uint16_t minute = 0;
+		uint16_t second = 0;
+		uint16_t millisecond = 0;
+
+		ReadUInt16(input, end, version);
+		ReadUInt16(input, end, hour);
+		ReadUInt16(input, end, minute);
+		ReadUInt16(input, end, second);
+		ReadUInt16(input, end, millisecond);
+
+		if (version != BinaryTraceFormat::Version)
+		{
+			std::fprintf(stderr, "Unsupported trace version: %u.\n", version);
+			return false;
+		}
+
+		DecoderState state;
+		state.startMilliseconds = ((((hour * 60ULL) + minute) * 60ULL) + second) * 1000ULL + millisecond;
+
+		if (outputFormat == OutputFormat::Csv)
+		{
+			std::fputs("elapsed_us,time,sim_month,call_site,message\n", output);
+		}
+
+		std::string text;
+
+		while (input < end)
+		{
+			const uint8_t* const recordStart = input;
+			const RecordType type = static_cast<RecordType>(*input++);
+			bool result = false;
+
+			switch (type)
+			{
+			case RecordType::FormatDefinition:
+			{
+				uint64_t id = 0;
+
+				if (BinaryTraceFormat::ReadVarint(input, end, id) && ReadText(input, end, text))
+				{
+					FormatInfo& format = state.formats[id];
+					format.text = text;
+					result = BinaryTraceFormat::ParseFormat(format.text.c_str(), format.arguments);
+				}
+				break;
+			}
+			case RecordType::StringDefinition:
+			{
+				uint64_t id = 0;
+
+				if (BinaryTraceFormat::ReadVarint(input, end, id) && ReadText(input, end, text))
+				{
+					state.strings[id] = text;
+					result = true;
+				}
+				break;
+			}
+			case RecordType::SimMonth:
+				result = BinaryTraceFormat::ReadVarint(input, end, state.simMonth);
+				break;
+			case RecordType::HeaderLine:
+				if (ReadText(input, end, text))
+				{
+					WriteLine(output, outputFormat, state, false, -1, text);
+					result = true;
+				}
+				break;
+			case RecordType::Entry:
+			{
+				uint64_t formatID = 0;
+				uint64_t elapsed = 0;
+
+				if (BinaryTraceFormat::ReadVarint(input, end, formatID)
+					&& BinaryTraceFormat::ReadVarint(input, end, elapsed))
+				{
+					auto it = state.formats.find(formatID);
+
+					text.clear();
+
+					if (it != state.formats.end() && FormatEntry(it->second, state, input, end, text))
+					{
+						state.elapsedMicroseconds += elapsed;
+						WriteLine(output, outputFormat, state, true, static_cast<int64_t>(formatID), text);
+						result = true;
+					}
+				}
+				break;
+			}
+			case RecordType::TextLine:
+			{
+				uint64_t elapsed = 0;
+
+				if (BinaryTraceFormat::ReadVarint(input, end, elapsed) && ReadText(input, end, text))
+				{
+					state.elapsedMicroseconds += elapsed;
+					WriteLine(output, outputFormat, state, true, -1, text);
+					result = true;
+				}
+				break;
+			}
+			}
+
+			if (!result)
+			{
+				std::fprintf(
+					stderr,
+					"Invalid record at offset %zu.\n",
+					static_cast<size_t>(recordStart - trace.data()));
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	DecoderOptions options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::ifstream inputFile(options.inputPath, std::ifstream::binary);
+
+	if (!inputFile)
+	{
+		std::fprintf(stderr, "Failed to open %s.\n", options.inputPath.string().c_str());
+		return EXIT_FAILURE;
+	}
+
+	const std::vector<uint8_t> trace((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+
+	std::FILE* output = stdout;
+
+	if (!options.outputPath.empty())
+	{
+		output = std::fopen(options.outputPath.string().c_str(), "wb");
+
+		if (!output)
+		{
+			std::fprintf(stderr, "Failed to open %s.\n", options.outputPath.string().c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	const bool result = Decode(trace, output, options.outputFormat);
+
+	if (output != stdout)
+	{
+		std::fclose(output);
+	}
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}